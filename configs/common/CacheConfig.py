@@ -131,6 +131,12 @@ def config_cache(options, system):
             if options.l3_rp != '':
                 if options.l3_rp == "hawkeye":
                     system.ll.replacement_policy = HawkeyeRP()
+                    if options.hawkeye_per_core:
+                        system.ll.replacement_policy.num_cores = \
+                            options.num_cpus
+                    if options.hawkeye_prefetch_predictor:
+                        system.ll.replacement_policy.prefetch_predictor = \
+                            True
                 elif options.l3_rp == "ship":
                     system.ll.replacement_policy = SHiPPCRP();
                 elif options.l3_rp == "brrip":
@@ -154,6 +154,12 @@ def addNoISAOptions(parser):
     parser.add_argument("--l2_assoc", type=int, default=8)
     parser.add_argument("--l3_assoc", type=int, default=16)
     parser.add_argument("--l3_rp", type=str, help="LLC replacement policy")
+    parser.add_argument("--hawkeye-per-core", action="store_true",
+                        help="Give every CPU its own Hawkeye predictor "
+                        "with --l3_rp hawkeye")
+    parser.add_argument("--hawkeye-prefetch-predictor", action="store_true",
+                        help="Predict hardware prefetches with their own "
+                        "Hawkeye predictor with --l3_rp hawkeye")
     parser.add_argument("--cacheline_size", type=int, default=64)
 
     # Enable Ruby
@@ -144,6 +144,12 @@ class SnoopFilter(SimObject):
     # Sanity check on max capacity to track, adjust if needed.
     max_capacity = Param.MemorySize('8MiB', "Maximum capacity of snoop filter")
 
+    # Associativity of the snoop filter. A bounded filter evicts lines when
+    # a set is full and invalidates them in the caches holding them. The
+    # default of 0 tracks up to max_capacity lines in any set.
+    assoc = Param.Unsigned(0, "Associativity of the snoop filter, "
+                           "0 for unbounded")
+
 # We use a coherent crossbar to connect multiple requestors to the L2
 # caches. Normally this crossbar would be part of the cache itself.
 class L2XBar(CoherentXBar):
@@ -49,6 +49,7 @@
 #include "base/trace.hh"
 #include "debug/Bridge.hh"
 #include "params/Bridge.hh"
+#include "sim/simulate.hh"
 
 namespace gem5
 {
@@ -107,6 +108,19 @@ Bridge::init()
 
     // notify the request side  of our address ranges
     cpuSidePort.sendRangeChange();
+
+    // Requests and responses that reach the bridge are only forwarded
+    // after its delay, which is the lookahead from the queues of the
+    // peers to ours
+    const Tick latency = cyclesToTicks(ticksToCycles(params().delay));
+    if (latency) {
+        auto &cpu_side = static_cast<RequestPort &>(cpuSidePort.getPeer());
+        auto &mem_side = static_cast<ResponsePort &>(memSidePort.getPeer());
+        declareLookahead(cpu_side.getOwner().eventQueue(), eventQueue(),
+                         latency);
+        declareLookahead(mem_side.getOwner().eventQueue(), eventQueue(),
+                         latency);
+    }
 }
 
 bool
@@ -323,7 +323,7 @@ class Bridge : public ClockedObject
 
     void init() override;
 
-    typedef BridgeParams Params;
+    PARAMS(Bridge);
 
     Bridge(const Params &p);
 };
@@ -38,7 +38,7 @@
 
 from m5.params import *
 from m5.proxy import *
-from m5.SimObject import SimObject
+from m5.SimObject import SimObject, PyBindMethod
 
 from m5.objects.ClockedObject import ClockedObject
 from m5.objects.Compressors import BaseCacheCompressor
@@ -76,6 +76,10 @@ class BaseCache(ClockedObject):
     cxx_header = "mem/cache/base.hh"
     cxx_class = 'gem5::BaseCache'
 
+    cxx_exports = [
+        PyBindMethod("inCache"),
+    ]
+
     size = Param.MemorySize("Capacity")
     assoc = Param.Unsigned("Associativity")
 
@@ -89,10 +93,20 @@ class BaseCache(ClockedObject):
     max_miss_count = Param.Counter(0,
         "Number of misses to handle before calling exit")
 
+    # Functional warm-up of the tags and the replacement state, e.g., from
+    # a MemTraceProbe trace of the accesses preceding a checkpoint. Only
+    # meant for caches that no snoop filter tracks, such as the LLC.
+    warmup_trace = Param.String("",
+        "Packet trace to functionally warm the cache up with at startup")
+
     mshrs = Param.Unsigned("Number of MSHRs (max outstanding requests)")
     demand_mshr_reserve = Param.Unsigned(1, "MSHRs reserved for demand access")
     tgts_per_mshr = Param.Unsigned("Max number of accesses per MSHR")
     write_buffers = Param.Unsigned(8, "Number of write buffers")
+    # Caches with many MSHRs or write buffers spend a noticeable time
+    # scanning them for a matching block on every access
+    indexed_queues = Param.Bool(False,
+        "Index the MSHRs and write buffers by block address")
 
     is_read_only = Param.Bool(False, "Is this cache read only (e.g. inst)")
 
@@ -45,8 +45,11 @@
 
 #include "mem/cache/base.hh"
 
+#include <unordered_map>
+
 #include "base/compiler.hh"
 #include "base/logging.hh"
+#include "config/have_protobuf.hh"
 #include "debug/Cache.hh"
 #include "debug/CacheComp.hh"
 #include "debug/CachePort.hh"
@@ -63,6 +66,11 @@
 #include "params/WriteAllocator.hh"
 #include "sim/cur_tick.hh"
 
+#if HAVE_PROTOBUF
+#include "proto/packet.pb.h"
+#include "proto/protoio.hh"
+#endif
+
 namespace gem5
 {
 
@@ -80,8 +88,10 @@ BaseCache::BaseCache(const BaseCacheParams &p, unsigned blk_size)
     : ClockedObject(p),
       cpuSidePort (p.name + ".cpu_side_port", this, "CpuSidePort"),
       memSidePort(p.name + ".mem_side_port", this, "MemSidePort"),
-      mshrQueue("MSHRs", p.mshrs, 0, p.demand_mshr_reserve, p.name),
-      writeBuffer("write buffer", p.write_buffers, p.mshrs, p.name),
+      mshrQueue("MSHRs", p.mshrs, 0, p.demand_mshr_reserve, p.name,
+                p.indexed_queues),
+      writeBuffer("write buffer", p.write_buffers, p.mshrs, p.name,
+                  p.indexed_queues),
       tags(p.tags),
       compressor(p.compressor),
       prefetcher(p.prefetcher),
@@ -109,6 +119,7 @@ BaseCache::BaseCache(const BaseCacheParams &p, unsigned blk_size)
       noTargetMSHR(nullptr),
       missCount(p.max_miss_count),
       addrRanges(p.addr_ranges.begin(), p.addr_ranges.end()),
+      warmupTrace(p.warmup_trace),
       system(p.system),
       stats(*this)
 {
@@ -197,6 +208,132 @@ BaseCache::init()
     forwardSnoops = cpuSidePort.isSnooping();
 }
 
+void
+BaseCache::startup()
+{
+    // Warm up once the memories are loaded, or restored, and before the
+    // first access arrives
+    if (!warmupTrace.empty()) {
+        warmUp(warmupTrace);
+
+        // The warm-up accesses are not part of the simulation, so do not
+        // count them in the stats of the cache, its tags and policies
+        resetStats();
+    }
+}
+
+void
+BaseCache::warmUp(const std::string &trace_file)
+{
+#if HAVE_PROTOBUF
+    ProtoInputStream trace(trace_file);
+    ProtoMessage::PacketHeader header_msg;
+    fatal_if(!trace.read(header_msg),
+             "Failed to read packet header from %s", trace_file);
+
+    // The replacement policies know the requestors by their IDs, which
+    // may differ from the ones the trace was recorded with
+    std::unordered_map<uint32_t, RequestorID> requestor_ids;
+    for (const auto &id_string : header_msg.id_strings()) {
+        const RequestorID id = system->lookupRequestorId(id_string.value());
+        if (id != Request::invldRequestorId)
+            requestor_ids[id_string.key()] = id;
+    }
+
+    // The policies order accesses by the tick they happened at
+    EventQueue *const eventq = eventQueue();
+    const Tick start_tick = eventq->getCurTick();
+    bool warned_ticks = false;
+
+    std::vector<uint64_t> data(blkSize / sizeof(uint64_t));
+    uint64_t num_accesses = 0;
+    uint64_t num_fills = 0;
+    ProtoMessage::Packet pkt_msg;
+    while (trace.read(pkt_msg)) {
+        const MemCmd cmd(static_cast<MemCmd::Command>(pkt_msg.cmd()));
+        const Request::FlagsType flags =
+            pkt_msg.has_flags() ? pkt_msg.flags() : 0;
+        const Addr blk_addr = pkt_msg.addr() & ~(Addr(blkSize - 1));
+
+        // Only warm with the accesses the cache would allocate on
+        if (!cmd.isRequest() || !(cmd.isRead() || cmd.isWrite()) ||
+            (flags & Request::UNCACHEABLE) || !system->isMemAddr(blk_addr)) {
+            continue;
+        }
+
+        if (pkt_msg.tick() > start_tick && !warned_ticks) {
+            warn("%s: Warm-up trace %s has accesses after the simulation "
+                 "start, the warmed blocks will look more recent than the "
+                 "first simulated accesses\n", name(), trace_file);
+            warned_ticks = true;
+        }
+        eventq->setCurTick(pkt_msg.tick());
+
+        auto requestor_it = pkt_msg.has_pkt_id() ?
+            requestor_ids.find(pkt_msg.pkt_id()) : requestor_ids.end();
+        RequestPtr req = std::make_shared<Request>(blk_addr, blkSize,
+            flags & Request::SECURE,
+            (requestor_it != requestor_ids.end()) ?
+                requestor_it->second : Request::funcRequestorId);
+        if (pkt_msg.has_pc())
+            req->setPC(pkt_msg.pc());
+        Packet pkt(req, cmd);
+        num_accesses++;
+
+        // A hit only updates the replacement state
+        Cycles lat;
+        if (tags->accessBlock(&pkt, lat))
+            continue;
+
+        // Read the data of the block, which also gives the compressor
+        // something to work with
+        Packet fill_pkt(req, MemCmd::ReadReq);
+        fill_pkt.dataStatic(data.data());
+        memSidePort.sendFunctional(&fill_pkt);
+        pkt.dataStatic(data.data());
+
+        std::size_t blk_size_bits = blkSize * 8;
+        Cycles compression_lat = Cycles(0);
+        Cycles decompression_lat = Cycles(0);
+        if (compressor) {
+            blk_size_bits = compressor->compress(data.data(),
+                compression_lat, decompression_lat)->getSizeBits();
+        }
+
+        std::vector<CacheBlk*> evict_blks;
+        CacheBlk *victim = tags->findVictim(blk_addr, req->isSecure(),
+            blk_size_bits, evict_blks, req->requestorId());
+        if (!victim)
+            continue;
+
+        // Warmed blocks are clean, so evicting them is just dropping them
+        for (auto blk : evict_blks) {
+            if (blk->isValid()) {
+                assert(!blk->isSet(CacheBlk::DirtyBit));
+                invalidateBlock(blk);
+            }
+        }
+
+        tags->insertBlock(&pkt, victim);
+        if (compressor) {
+            compressor->setSizeBits(victim, blk_size_bits);
+            compressor->setDecompressionLatency(victim, decompression_lat);
+        }
+        victim->setCoherenceBits(CacheBlk::ReadableBit);
+        updateBlockData(victim, &pkt, false);
+        num_fills++;
+    }
+
+    eventq->setCurTick(start_tick);
+
+    inform("%s: Warmed up with %d accesses (%d fills) from %s\n", name(),
+           num_accesses, num_fills, trace_file);
+#else
+    fatal("%s: Cannot warm up from %s without Protobuf support\n",
+          name(), trace_file);
+#endif
+}
+
 Port &
 BaseCache::getPort(const std::string &if_name, PortID idx)
 {
@@ -1022,7 +1159,8 @@ BaseCache::updateCompressionData(CacheBlk *&blk, const uint64_t* data,
         CacheBlk *victim = nullptr;
         if (replaceExpansions || is_data_contraction) {
             victim = tags->findVictim(regenerateBlkAddr(blk),
-                blk->isSecure(), compression_size, evict_blks);
+                blk->isSecure(), compression_size, evict_blks,
+                blk->getSrcRequestorId());
 
             // It is valid to return nullptr if there is no victim
             if (!victim) {
@@ -1631,7 +1769,7 @@ BaseCache::allocateBlock(const PacketPtr pkt, PacketList &writebacks)
     // Find replacement victim
     std::vector<CacheBlk*> evict_blks;
     CacheBlk *victim = tags->findVictim(addr, is_secure, blk_size_bits,
-                                        evict_blks);
+                                        evict_blks, pkt->req->requestorId());
 
     // It is valid to return nullptr if there is no victim
     if (!victim)
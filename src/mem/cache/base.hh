@@ -862,6 +862,23 @@ class BaseCache : public ClockedObject
      */
     virtual void memInvalidate() override;
 
+    /**
+     * Functionally warm the tags and the replacement state up with the
+     * accesses of a packet trace, e.g., one recorded by a MemTraceProbe
+     * in front of this cache. No event is scheduled and no packet is
+     * sent: blocks are allocated straight in the tags, and their data is
+     * read with functional accesses. The ticks of the trace order the
+     * accesses for the replacement policies.
+     *
+     * Warmed blocks are readable but neither writable nor dirty, so that
+     * they do not have to be tracked by the caches and snoop filters
+     * below. As snoop filters do not know about them either, only warm
+     * caches that no snoop filter tracks, e.g., the last level cache.
+     *
+     * @param trace_file Name of the packet trace.
+     */
+    void warmUp(const std::string &trace_file);
+
     /**
      * Determine if there are any dirty blocks in the cache.
      *
@@ -981,6 +998,9 @@ class BaseCache : public ClockedObject
      * Normally this is all possible memory addresses. */
     const AddrRangeList addrRanges;
 
+    /** Packet trace to warm the cache up with at startup, if any. */
+    const std::string warmupTrace;
+
   public:
     /** System we are currently operating in. */
     System *system;
@@ -1154,6 +1174,7 @@ class BaseCache : public ClockedObject
     ~BaseCache();
 
     void init() override;
+    void startup() override;
 
     Port &getPort(const std::string &if_name,
                   PortID idx=InvalidPortID) override;
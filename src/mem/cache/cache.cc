@@ -1131,11 +1131,12 @@ Cache::handleSnoop(PacketPtr pkt, CacheBlk *blk, bool is_timing,
             // we no longer have the block, and will not respond, but a
             // packet was allocated in MSHR::handleSnoop and we have
             // to delete it
-            assert(pkt->needsResponse());
+            assert(pkt->needsResponse() ||
+                   pkt->cmd == MemCmd::BackInvalidateReq);
 
             // we have passed the block to a cache upstream, that
             // cache should be responding
-            assert(pkt->cacheResponding());
+            assert(pkt->cacheResponding() || !pkt->needsResponse());
 
             delete pkt;
         }
@@ -1185,6 +1186,24 @@ Cache::handleSnoop(PacketPtr pkt, CacheBlk *blk, bool is_timing,
         DPRINTF(Cache, "new state is %s\n", blk->print());
     }
 
+    if (pkt->cmd == MemCmd::BackInvalidateReq) {
+        // A snoop filter below no longer tracks the block. Evict it as
+        // if it was replaced, so that dirty data is written back, and
+        // have the filter keep tracking this cache until the eviction
+        // reaches it.
+        PacketList writebacks;
+        if (is_timing) {
+            writebacks.push_back(evictBlock(blk));
+            doWritebacks(writebacks, clockEdge(forwardLatency) +
+                         pkt->headerDelay);
+            pkt->setBlockCached();
+            blk_valid = false;
+        } else if (blk->isSet(CacheBlk::DirtyBit)) {
+            writebacks.push_back(writebackBlk(blk));
+            doWritebacksAtomic(writebacks);
+        }
+    }
+
     if (respond) {
         // prevent anyone else from responding, cache as well as
         // memory, and also prevent any memory from even seeing the
@@ -1230,7 +1249,8 @@ Cache::handleSnoop(PacketPtr pkt, CacheBlk *blk, bool is_timing,
     }
 
     if (!respond && is_deferred) {
-        assert(pkt->needsResponse());
+        assert(pkt->needsResponse() ||
+               pkt->cmd == MemCmd::BackInvalidateReq);
         delete pkt;
     }
 
@@ -1285,6 +1305,10 @@ Cache::recvTimingSnoopReq(PacketPtr pkt)
                 "mshrs: %s\n", blk_addr, is_secure ? "s" : "ns",
                 mshr->print());
 
+        // The block will be evicted once the MSHR is serviced
+        if (pkt->cmd == MemCmd::BackInvalidateReq)
+            pkt->setBlockCached();
+
         if (mshr->getNumTargets() > numTarget)
             warn("allocating bonus target for snoop"); //handle later
         return;
@@ -1342,7 +1366,13 @@ Cache::recvTimingSnoopReq(PacketPtr pkt)
                                    false, false);
         }
 
-        if (invalidate && wb_pkt->cmd != MemCmd::WriteClean) {
+        if (pkt->cmd == MemCmd::BackInvalidateReq) {
+            // The eviction is already on its way, the snoop filter that
+            // back-invalidates the block keeps tracking this cache until
+            // it reaches it
+            if (wb_pkt->isEviction())
+                pkt->setBlockCached();
+        } else if (invalidate && wb_pkt->cmd != MemCmd::WriteClean) {
             // Invalidation trumps our writeback... discard here
             // Note: markInService will remove entry from writeback buffer.
             markInService(wb_entry);
@@ -53,6 +53,12 @@ class BaseCacheCompressor(SimObject):
     decomp_extra_latency = Param.Cycles(1, "Number of extra cycles required "
         "to finish decompression (e.g., due to shifting and packaging).")
 
+    # Compressing the same contents always gives the same size, so the size
+    # of recently compressed lines can be remembered. The memo only holds
+    # sizes and latencies: memoized lines cannot be decompressed
+    memo_entries = Param.Unsigned(0, "Number of lines whose compressed "
+        "size is memoized by contents. 0 disables memoization")
+
 class BaseDictionaryCompressor(BaseCacheCompressor):
     type = 'BaseDictionaryCompressor'
     abstract = True
@@ -102,6 +102,15 @@ Base::Base(const Params &p)
         "chunks in the input");
 
     fatal_if(blkSize < sizeThreshold, "Compressed data must fit in a block");
+
+    if (p.memo_entries) {
+        // Memoized compression data cannot be decompressed to be checked
+        #ifdef DEBUG_COMPRESSION
+        fatal("Compression memoization cannot be used when debugging "
+            "compression.");
+        #endif
+        memo.reset(new Memo(p.memo_entries, blkSize));
+    }
 }
 
 void
@@ -113,21 +122,32 @@ Base::setCache(BaseCache *_cache)
 
 std::vector<Base::Chunk>
 Base::toChunks(const uint64_t* data) const
+{
+    std::vector<Chunk> chunks;
+    toChunks(data, chunks);
+    return chunks;
+}
+
+void
+Base::toChunks(const uint64_t* data, std::vector<Chunk>& chunks) const
 {
     // Number of chunks in a 64-bit value
     const unsigned num_chunks_per_64 =
         (sizeof(uint64_t) * CHAR_BIT) / chunkSizeBits;
 
     // Turn a 64-bit array into a chunkSizeBits-array
-    std::vector<Chunk> chunks((blkSize * CHAR_BIT) / chunkSizeBits, 0);
+    chunks.resize((blkSize * CHAR_BIT) / chunkSizeBits);
+    if (num_chunks_per_64 == 1) {
+        std::copy(data, data + chunks.size(), chunks.begin());
+        return;
+    }
+    const uint64_t chunk_mask = mask(chunkSizeBits);
     for (int i = 0; i < chunks.size(); i++) {
-        const int index_64 = std::floor(i / (double)num_chunks_per_64);
         const unsigned start = i % num_chunks_per_64;
-        chunks[i] = bits(data[index_64],
-            (start + 1) * chunkSizeBits - 1, start * chunkSizeBits);
+        chunks[i] =
+            (data[i / num_chunks_per_64] >> (start * chunkSizeBits)) &
+            chunk_mask;
     }
-
-    return chunks;
 }
 
 void
@@ -138,34 +158,57 @@ Base::fromChunks(const std::vector<Chunk>& chunks, uint64_t* data) const
         (sizeof(uint64_t) * CHAR_BIT) / chunkSizeBits;
 
     // Turn a chunkSizeBits-array into a 64-bit array
+    if (num_chunks_per_64 == 1) {
+        std::copy(chunks.begin(), chunks.end(), data);
+        return;
+    }
     std::memset(data, 0, blkSize);
     for (int i = 0; i < chunks.size(); i++) {
-        const int index_64 = std::floor(i / (double)num_chunks_per_64);
         const unsigned start = i % num_chunks_per_64;
-        replaceBits(data[index_64], (start + 1) * chunkSizeBits - 1,
-            start * chunkSizeBits, chunks[i]);
+        replaceBits(data[i / num_chunks_per_64],
+            (start + 1) * chunkSizeBits - 1, start * chunkSizeBits,
+            chunks[i]);
     }
 }
 
 std::unique_ptr<Base::CompressionData>
 Base::compress(const uint64_t* data, Cycles& comp_lat, Cycles& decomp_lat)
 {
-    // Apply compression
-    std::unique_ptr<CompressionData> comp_data =
-        compress(toChunks(data), comp_lat, decomp_lat);
-
-    // If we are in debug mode apply decompression just after the compression.
-    // If the results do not match, we've got an error
-    #ifdef DEBUG_COMPRESSION
-    uint64_t decomp_data[blkSize/8];
-
-    // Apply decompression
-    decompress(comp_data.get(), decomp_data);
-
-    // Check if decompressed line matches original cache line
-    fatal_if(std::memcmp(data, decomp_data, blkSize),
-             "Decompressed line does not match original line.");
-    #endif
+    std::unique_ptr<CompressionData> comp_data;
+    const Memo::Result* const memo_result =
+        memo ? memo->lookup(data) : nullptr;
+    if (memo_result) {
+        // The same contents have been compressed recently. Only their size
+        // is known, which is all the caches need
+        stats.memoHits++;
+        comp_data.reset(new CompressionData());
+        comp_data->setSizeBits(memo_result->sizeBits);
+        comp_lat = memo_result->compLat;
+        decomp_lat = memo_result->decompLat;
+    } else {
+        // Apply compression
+        toChunks(data, chunkBuffer);
+        comp_data = compress(chunkBuffer, comp_lat, decomp_lat);
+
+        // If we are in debug mode apply decompression just after the
+        // compression. If the results do not match, we've got an error
+        #ifdef DEBUG_COMPRESSION
+        uint64_t decomp_data[blkSize/8];
+
+        // Apply decompression
+        decompress(comp_data.get(), decomp_data);
+
+        // Check if decompressed line matches original cache line
+        fatal_if(std::memcmp(data, decomp_data, blkSize),
+                 "Decompressed line does not match original line.");
+        #endif
+
+        if (memo) {
+            stats.memoMisses++;
+            memo->insert(data,
+                {comp_data->getSizeBits(), comp_lat, decomp_lat});
+        }
+    }
 
     // Get compression size. If compressed size is greater than the size
     // threshold, the compression is seen as unsuccessful
@@ -246,7 +289,11 @@ Base::BaseStats::BaseStats(Base& _compressor)
                 statistics::units::Bit, statistics::units::Count>::get(),
              "Average compression size"),
     ADD_STAT(decompressions, statistics::units::Count::get(),
-             "Total number of decompressions")
+             "Total number of decompressions"),
+    ADD_STAT(memoHits, statistics::units::Count::get(),
+             "Number of compressions answered by the memo"),
+    ADD_STAT(memoMisses, statistics::units::Count::get(),
+             "Number of compressions that missed in the memo")
 {
 }
 
@@ -37,10 +37,12 @@
 #define __MEM_CACHE_COMPRESSORS_BASE_HH__
 
 #include <cstdint>
+#include <memory>
 
 #include "base/compiler.hh"
 #include "base/statistics.hh"
 #include "base/types.hh"
+#include "mem/cache/compressors/memo.hh"
 #include "sim/sim_object.hh"
 
 namespace gem5
@@ -129,6 +131,15 @@ class Base : public SimObject
     /** Pointer to the parent cache. */
     BaseCache* cache;
 
+    /** Chunks of the line being compressed, kept to reuse their storage. */
+    std::vector<Chunk> chunkBuffer;
+
+    /**
+     * Optional memo of the compressed sizes of the last lines compressed,
+     * so that compressing the same contents again is a lookup.
+     */
+    std::unique_ptr<Memo> memo;
+
     struct BaseStats : public statistics::Group
     {
         const Base& compressor;
@@ -154,6 +165,12 @@ class Base : public SimObject
 
         /** Number of decompressions performed. */
         statistics::Scalar decompressions;
+
+        /** Number of compressions answered by the memo. */
+        statistics::Scalar memoHits;
+
+        /** Number of compressions that missed in the memo. */
+        statistics::Scalar memoMisses;
     } stats;
 
     /**
@@ -165,6 +182,15 @@ class Base : public SimObject
      */
     std::vector<Chunk> toChunks(const uint64_t* data) const;
 
+    /**
+     * Split the raw data into chunks, reusing the storage of the given
+     * vector, so that the common compression path does not allocate.
+     *
+     * @param data The raw pointer to the data being compressed.
+     * @param chunks The raw data divided into a vector of sequential chunks.
+     */
+    void toChunks(const uint64_t* data, std::vector<Chunk>& chunks) const;
+
     /**
      * This function re-joins the chunks to recreate the original data.
      *
@@ -206,6 +232,12 @@ class Base : public SimObject
     /** The cache can only be set once. */
     virtual void setCache(BaseCache *_cache);
 
+    /**
+     * Whether the compressed size of a line only depends on its contents,
+     * so that it can be memoized.
+     */
+    virtual bool memoizable() const { return true; }
+
     /**
      * Apply the compression process to the cache line. Ignores compression
      * cycles.
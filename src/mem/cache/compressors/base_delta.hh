@@ -99,12 +99,17 @@ class BaseDelta : public DictionaryCompressor<BaseType>
     using PatternFactory = typename DictionaryCompressor<BaseType>::template
         Factory<PatternM, PatternX>;
 
-    std::unique_ptr<typename DictionaryCompressor<BaseType>::Pattern>
+    using PatternSlot =
+        typename DictionaryCompressor<BaseType>::PatternSlot;
+
+    typename DictionaryCompressor<BaseType>::Pattern*
     getPattern(const DictionaryEntry& bytes,
         const DictionaryEntry& dict_bytes,
-        const int match_location) const override
+        const int match_location,
+        PatternSlot& slot) const override
     {
-        return PatternFactory::getPattern(bytes, dict_bytes, match_location);
+        return PatternFactory::getPattern(bytes, dict_bytes, match_location,
+            slot);
     }
 
     std::string
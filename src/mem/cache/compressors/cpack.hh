@@ -94,12 +94,13 @@ class CPack : public DictionaryCompressor<uint32_t>
         return patternNames[number];
     };
 
-    std::unique_ptr<Pattern> getPattern(
+    Pattern* getPattern(
         const DictionaryEntry& bytes,
         const DictionaryEntry& dict_bytes,
-        const int match_location) const override
+        const int match_location, PatternSlot& slot) const override
     {
-        return PatternFactory::getPattern(bytes, dict_bytes, match_location);
+        return PatternFactory::getPattern(bytes, dict_bytes, match_location,
+            slot);
     }
 
     void addToDictionary(DictionaryEntry data) override;
@@ -44,9 +44,11 @@
 #define __MEM_CACHE_COMPRESSORS_DICTIONARY_COMPRESSOR_HH__
 
 #include <array>
+#include <cstddef>
 #include <cstdint>
 #include <map>
 #include <memory>
+#include <new>
 #include <string>
 #include <type_traits>
 #include <vector>
@@ -129,6 +131,7 @@ class DictionaryCompressor : public BaseDictionaryCompressor
 
     // Forward declaration of a pattern
     class Pattern;
+    class PatternSlot;
     class UncompressedPattern;
     template <T mask>
     class MaskedPattern;
@@ -146,26 +149,27 @@ class DictionaryCompressor : public BaseDictionaryCompressor
     /**
      * Create a factory to determine if input matches a pattern. The if else
      * chains are constructed by recursion. The patterns should be explored
-     * sorted by size for correct behaviour.
+     * sorted by size for correct behaviour. The matching pattern is
+     * constructed in the given slot, so no pattern is heap allocated.
      */
     template <class Head, class... Tail>
     struct Factory
     {
-        static std::unique_ptr<Pattern> getPattern(
-            const DictionaryEntry& bytes, const DictionaryEntry& dict_bytes,
-            const int match_location)
+        static Pattern*
+        getPattern(const DictionaryEntry& bytes,
+            const DictionaryEntry& dict_bytes, const int match_location,
+            PatternSlot& slot)
         {
             // If match this pattern, instantiate it. If a negative match
             // location is used, the patterns that use the dictionary bytes
             // must return false. This is used when there are no dictionary
             // entries yet
             if (Head::isPattern(bytes, dict_bytes, match_location)) {
-                return std::unique_ptr<Pattern>(
-                            new Head(bytes, match_location));
+                return slot.template emplace<Head>(bytes, match_location);
             // Otherwise, go for next pattern
             } else {
                 return Factory<Tail...>::getPattern(bytes, dict_bytes,
-                                                    match_location);
+                                                    match_location, slot);
             }
         }
     };
@@ -183,33 +187,47 @@ class DictionaryCompressor : public BaseDictionaryCompressor
             "The last pattern must always be derived from the uncompressed "
             "pattern.");
 
-        static std::unique_ptr<Pattern>
+        static Pattern*
         getPattern(const DictionaryEntry& bytes,
-            const DictionaryEntry& dict_bytes, const int match_location)
+            const DictionaryEntry& dict_bytes, const int match_location,
+            PatternSlot& slot)
         {
-            return std::unique_ptr<Pattern>(new Head(bytes, match_location));
+            return slot.template emplace<Head>(bytes, match_location);
         }
     };
 
     /** The dictionary. */
     std::vector<DictionaryEntry> dictionary;
 
+    /**
+     * Slot where the candidate patterns of a value are built while looking
+     * for the best one.
+     */
+    PatternSlot candidateSlot;
+
     /**
      * Since the factory cannot be instantiated here, classes that inherit
      * from this base class have to implement the call to their factory's
      * getPattern.
+     *
+     * @param bytes The value being compressed.
+     * @param dict_bytes The dictionary entry it is matched against.
+     * @param match_location The index of the dictionary entry, or -1.
+     * @param slot The slot where the matching pattern is constructed.
+     * @return The matching pattern, which lives in the slot.
      */
-    virtual std::unique_ptr<Pattern>
+    virtual Pattern*
     getPattern(const DictionaryEntry& bytes, const DictionaryEntry& dict_bytes,
-        const int match_location) const = 0;
+        const int match_location, PatternSlot& slot) const = 0;
 
     /**
      * Compress data.
      *
      * @param data Data to be compressed.
-     * @return The pattern this data matches.
+     * @param slot The slot where the best pattern is constructed.
+     * @return The pattern this data matches, which lives in the slot.
      */
-    std::unique_ptr<Pattern> compressValue(const T data);
+    Pattern* compressValue(const T data, PatternSlot& slot);
 
     /**
      * Decompress a pattern into a value that fits in a dictionary entry.
@@ -389,22 +407,126 @@ class DictionaryCompressor<T>::Pattern
         const DictionaryEntry dict_bytes) const = 0;
 };
 
+/**
+ * In-place storage for a single pattern. Patterns are small, and there is
+ * one per chunk of a line, plus one per dictionary entry tried on each
+ * chunk, so constructing them in slots instead of on the heap removes most
+ * of the cost of compressing a line.
+ */
 template <class T>
-class DictionaryCompressor<T>::CompData : public CompressionData
+class DictionaryCompressor<T>::PatternSlot
 {
   public:
-    /** The patterns matched in the original line. */
-    std::vector<std::unique_ptr<Pattern>> entries;
+    /** Size, in bytes, of the largest pattern a slot can hold. */
+    static constexpr std::size_t MaxPatternSize = 64;
+
+  private:
+    /** Storage of the pattern. */
+    alignas(std::max_align_t) unsigned char storage[MaxPatternSize];
+
+    /** The pattern constructed in the storage, if any. */
+    Pattern* pattern;
+
+  public:
+    PatternSlot() : pattern(nullptr) {}
+    PatternSlot(const PatternSlot&) = delete;
+    PatternSlot& operator=(const PatternSlot&) = delete;
+    ~PatternSlot() { clear(); }
 
+    /**
+     * Construct a pattern in the slot, destroying the previous one.
+     *
+     * @tparam P The type of the pattern.
+     * @param bytes The value the pattern represents.
+     * @param match_location The index of the dictionary match location.
+     * @return The new pattern.
+     */
+    template <class P>
+    P*
+    emplace(const DictionaryEntry& bytes, const int match_location)
+    {
+        static_assert(sizeof(P) <= MaxPatternSize,
+            "The pattern does not fit in a pattern slot.");
+        static_assert(alignof(P) <= alignof(std::max_align_t),
+            "The pattern is over-aligned for a pattern slot.");
+
+        clear();
+        P* const new_pattern = new (storage) P(bytes, match_location);
+        pattern = new_pattern;
+        return new_pattern;
+    }
+
+    /** Destroy the pattern in the slot, if any. */
+    void
+    clear()
+    {
+        if (pattern) {
+            pattern->~Pattern();
+            pattern = nullptr;
+        }
+    }
+
+    /**
+     * Get the pattern in the slot.
+     *
+     * @return The pattern, or nullptr if the slot is empty.
+     */
+    Pattern* get() const { return pattern; }
+};
+
+template <class T>
+class DictionaryCompressor<T>::CompData : public CompressionData
+{
+  private:
+    /**
+     * The patterns matched in the original line. The slots are allocated
+     * once per line, and are filled in order.
+     */
+    std::unique_ptr<PatternSlot[]> entries;
+
+    /** Number of slots allocated. */
+    std::size_t capacity;
+
+    /** Number of patterns added to the list. */
+    std::size_t numPatterns;
+
+  public:
     CompData();
     ~CompData() = default;
 
+    /**
+     * Allocate the slots of the patterns. Must be called before any pattern
+     * is added.
+     *
+     * @param num_entries Maximum number of patterns of the line.
+     */
+    void reserve(std::size_t num_entries);
+
+    /**
+     * Get the slot where the next pattern must be constructed before it is
+     * added to the list.
+     *
+     * @return The slot of the next pattern.
+     */
+    PatternSlot& nextSlot();
+
     /**
      * Add a pattern entry to the list of patterns.
      *
-     * @param entry The new pattern entry.
+     * @param entry The new pattern entry, constructed in nextSlot().
+     */
+    virtual void addEntry(Pattern* pattern);
+
+    /** @return The number of patterns in the list. */
+    std::size_t getNumEntries() const { return numPatterns; }
+
+    /**
+     * Get a pattern of the list.
+     *
+     * @param index The position of the pattern in the list.
+     * @return The pattern.
      */
-    virtual void addEntry(std::unique_ptr<Pattern>);
+    Pattern* getEntry(std::size_t index) const;
 };
 
 /**
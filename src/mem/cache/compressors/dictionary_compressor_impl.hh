@@ -49,19 +49,46 @@ namespace compression
 
 template <class T>
 DictionaryCompressor<T>::CompData::CompData()
-    : CompressionData()
+    : CompressionData(), capacity(0), numPatterns(0)
 {
 }
 
 template <class T>
 void
-DictionaryCompressor<T>::CompData::addEntry(std::unique_ptr<Pattern> pattern)
+DictionaryCompressor<T>::CompData::reserve(std::size_t num_entries)
 {
+    assert(numPatterns == 0);
+    entries.reset(new PatternSlot[num_entries]);
+    capacity = num_entries;
+}
+
+template <class T>
+typename DictionaryCompressor<T>::PatternSlot&
+DictionaryCompressor<T>::CompData::nextSlot()
+{
+    assert(numPatterns < capacity);
+    return entries[numPatterns];
+}
+
+template <class T>
+void
+DictionaryCompressor<T>::CompData::addEntry(Pattern* pattern)
+{
+    assert(pattern == nextSlot().get());
+
     // Increase size
     setSizeBits(getSizeBits() + pattern->getSizeBits());
 
-    // Push new entry to list
-    entries.push_back(std::move(pattern));
+    // The pattern is already in place, so just account for it
+    numPatterns++;
+}
+
+template <class T>
+typename DictionaryCompressor<T>::Pattern*
+DictionaryCompressor<T>::CompData::getEntry(std::size_t index) const
+{
+    assert(index < numPatterns);
+    return entries[index].get();
 }
 
 template <class T>
@@ -92,28 +119,38 @@ DictionaryCompressor<T>::instantiateDictionaryCompData() const
 }
 
 template <typename T>
-std::unique_ptr<typename DictionaryCompressor<T>::Pattern>
-DictionaryCompressor<T>::compressValue(const T data)
+typename DictionaryCompressor<T>::Pattern*
+DictionaryCompressor<T>::compressValue(const T data, PatternSlot& slot)
 {
     // Split data in bytes
     const DictionaryEntry bytes = toDictionaryEntry(data);
+    const DictionaryEntry no_match_bytes = toDictionaryEntry(0);
 
     // Start as a no-match pattern. A negative match location is used so that
     // patterns that depend on the dictionary entry don't match
-    std::unique_ptr<Pattern> pattern =
-        getPattern(bytes, toDictionaryEntry(0), -1);
+    std::size_t best_size =
+        getPattern(bytes, no_match_bytes, -1, candidateSlot)->getSizeBits();
+    int best_location = -1;
 
-    // Search for word on dictionary
+    // Search for word on dictionary. The candidates are only built to get
+    // their sizes, so they share a single slot
     for (std::size_t i = 0; i < numEntries; i++) {
         // Try matching input with possible patterns
-        std::unique_ptr<Pattern> temp_pattern =
-            getPattern(bytes, dictionary[i], i);
+        const std::size_t size =
+            getPattern(bytes, dictionary[i], i, candidateSlot)->getSizeBits();
 
         // Check if found pattern is better than previous
-        if (temp_pattern->getSizeBits() < pattern->getSizeBits()) {
-            pattern = std::move(temp_pattern);
+        if (size < best_size) {
+            best_size = size;
+            best_location = i;
         }
     }
+    candidateSlot.clear();
+
+    // Build the best pattern in its final place
+    Pattern* const pattern = getPattern(bytes,
+        (best_location < 0) ? no_match_bytes : dictionary[best_location],
+        best_location, slot);
 
     // Update stats
     dictionaryStats.patterns[pattern->getPatternNumber()]++;
@@ -138,11 +175,13 @@ DictionaryCompressor<T>::compress(const std::vector<Chunk>& chunks)
 
     // Compress every value sequentially
     CompData* const comp_data_ptr = static_cast<CompData*>(comp_data.get());
+    comp_data_ptr->reserve(chunks.size());
     for (const auto& value : chunks) {
-        std::unique_ptr<Pattern> pattern = compressValue(value);
+        Pattern* const pattern =
+            compressValue(value, comp_data_ptr->nextSlot());
         DPRINTF(CacheComp, "Compressed %016x to %s\n", value,
             pattern->print());
-        comp_data_ptr->addEntry(std::move(pattern));
+        comp_data_ptr->addEntry(pattern);
     }
 
     // Return compressed line
@@ -195,8 +234,10 @@ DictionaryCompressor<T>::decompress(const CompressionData* comp_data,
 
     // Decompress every entry sequentially
     std::vector<T> decomp_values;
-    for (const auto& entry : casted_comp_data->entries) {
-        const T value = decompressValue(&*entry);
+    decomp_values.reserve(casted_comp_data->getNumEntries());
+    for (std::size_t i = 0; i < casted_comp_data->getNumEntries(); i++) {
+        const Pattern* const entry = casted_comp_data->getEntry(i);
+        const T value = decompressValue(entry);
         decomp_values.push_back(value);
         DPRINTF(CacheComp, "Decompressed %s to %x\n", entry->print(), value);
     }
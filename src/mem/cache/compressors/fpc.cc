@@ -44,38 +44,39 @@ FPC::FPCCompData::FPCCompData(int zero_run_size_bits)
 }
 
 void
-FPC::FPCCompData::addEntry(std::unique_ptr<Pattern> pattern)
+FPC::FPCCompData::addEntry(Pattern* pattern)
 {
     // If this is a zero match, check for zero runs
     if (pattern->getPatternNumber() == ZERO_RUN) {
         // If it is a new zero run, create it; otherwise, increase current
         // run's length
-        if (!entries.size() ||
-            (entries.back()->getPatternNumber() != ZERO_RUN)) {
-            static_cast<ZeroRun*>(pattern.get())->setRealSize(zeroRunSizeBits);
+        const std::size_t num_entries = getNumEntries();
+        if (!num_entries ||
+            (getEntry(num_entries - 1)->getPatternNumber() != ZERO_RUN)) {
+            static_cast<ZeroRun*>(pattern)->setRealSize(zeroRunSizeBits);
         } else {
             // A zero run has a maximum length, given by the number of bits
             // used to represent it. When this limit is reached, a new run
             // must be created
-            const int run_length =
-                static_cast<ZeroRun*>(entries.back().get())->getRunLength();
+            const int run_length = static_cast<ZeroRun*>(
+                getEntry(num_entries - 1))->getRunLength();
             if (run_length == mask(zeroRunSizeBits)) {
                 // The limit for this zero run has been reached, so a new
                 // run must be started, with a sized pattern
-                static_cast<ZeroRun*>(pattern.get())->setRealSize(
+                static_cast<ZeroRun*>(pattern)->setRealSize(
                     zeroRunSizeBits);
             } else {
                 // Increase the current run's length.
                 // Since the first zero entry of the run contains the size,
                 // and all the following ones are created just to simplify
                 // decompression, this fake pattern will have a size of 0 bits
-                static_cast<ZeroRun*>(pattern.get())->setRunLength(
+                static_cast<ZeroRun*>(pattern)->setRunLength(
                     run_length + 1);
             }
         }
     }
 
-    CompData::addEntry(std::move(pattern));
+    CompData::addEntry(pattern);
 }
 
 FPC::FPC(const Params &p)
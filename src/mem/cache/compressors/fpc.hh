@@ -113,15 +113,16 @@ class FPC : public DictionaryCompressor<uint32_t>
         return patternNames[number];
     };
 
-    std::unique_ptr<Pattern> getPattern(
+    Pattern* getPattern(
         const DictionaryEntry& bytes,
         const DictionaryEntry& dict_bytes,
-        const int match_location) const override
+        const int match_location, PatternSlot& slot) const override
     {
         using PatternFactory = Factory<ZeroRun, SignExtended4Bits,
             SignExtended1Byte, SignExtendedHalfword, ZeroPaddedHalfword,
             SignExtendedTwoHalfwords, RepBytes, Uncompressed>;
-        return PatternFactory::getPattern(bytes, dict_bytes, match_location);
+        return PatternFactory::getPattern(bytes, dict_bytes, match_location,
+            slot);
     }
 
     void addToDictionary(const DictionaryEntry data) override;
@@ -148,7 +149,7 @@ class FPC::FPCCompData : public DictionaryCompressor<uint32_t>::CompData
     FPCCompData(int zeroRunSizeBits);
     ~FPCCompData() = default;
 
-    void addEntry(std::unique_ptr<Pattern> pattern) override;
+    void addEntry(Pattern* pattern) override;
 };
 
 // Pattern implementations
@@ -136,11 +136,12 @@ class FPCD : public DictionaryCompressor<uint32_t>
         return pattern_names[(PatternNumber)number];
     };
 
-    std::unique_ptr<Pattern>
+    Pattern*
     getPattern(const DictionaryEntry& bytes, const DictionaryEntry& dict_bytes,
-        const int match_location) const override
+        const int match_location, PatternSlot& slot) const override
     {
-        return PatternFactory::getPattern(bytes, dict_bytes, match_location);
+        return PatternFactory::getPattern(bytes, dict_bytes, match_location,
+            slot);
     }
 
     void addToDictionary(DictionaryEntry data) override;
@@ -58,6 +58,8 @@ FrequentValues::FrequentValues(const Params &p)
 {
     fatal_if((numVFTEntries - 1) > mask(chunkSizeBits),
         "There are more VFT entries than possible values.");
+    fatal_if(memo != nullptr, "The encoding of the frequent values "
+        "compressor changes over time, so its results cannot be memoized.");
 }
 
 std::unique_ptr<Base::CompressionData>
@@ -190,6 +190,9 @@ class FrequentValues : public Base
     void probeNotify(const DataUpdate &data_update);
 
     void regProbeListeners() override;
+
+    /** The encoding changes as the values are sampled. */
+    bool memoizable() const override { return false; }
 };
 
 class FrequentValues::CompData : public CompressionData
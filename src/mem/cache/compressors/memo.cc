@@ -0,0 +1,145 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** @file
+ * Implementation of a bounded memo of compression results.
+ */
+
+#include "mem/cache/compressors/memo.hh"
+
+#include <algorithm>
+#include <cassert>
+
+namespace gem5
+{
+
+namespace compression
+{
+
+Memo::Memo(std::size_t num_entries, std::size_t blk_size)
+  : lineWords(blk_size / sizeof(uint64_t)), entries(num_entries),
+    lines(num_entries * lineWords), numValid(0), head(Invalid),
+    tail(Invalid)
+{
+    assert(num_entries > 0);
+    index.reserve(num_entries);
+}
+
+uint64_t
+Memo::hash(const uint64_t* data) const
+{
+    uint64_t h = lineWords;
+    for (std::size_t i = 0; i < lineWords; i++) {
+        h = (h ^ data[i]) * 0x9e3779b97f4a7c15;
+        h ^= h >> 32;
+    }
+    return h;
+}
+
+void
+Memo::unlink(unsigned entry)
+{
+    Entry &e = entries[entry];
+    if (e.prev != Invalid) {
+        entries[e.prev].next = e.next;
+    } else {
+        head = e.next;
+    }
+    if (e.next != Invalid) {
+        entries[e.next].prev = e.prev;
+    } else {
+        tail = e.prev;
+    }
+}
+
+void
+Memo::pushFront(unsigned entry)
+{
+    Entry &e = entries[entry];
+    e.prev = Invalid;
+    e.next = head;
+    if (head != Invalid) {
+        entries[head].prev = entry;
+    } else {
+        tail = entry;
+    }
+    head = entry;
+}
+
+const Memo::Result*
+Memo::lookup(const uint64_t* data)
+{
+    const auto it = index.find(hash(data));
+    if (it == index.end()) {
+        return nullptr;
+    }
+
+    // A different line with the same hash is a miss
+    const unsigned entry = it->second;
+    const uint64_t* const line = &lines[entry * lineWords];
+    if (!std::equal(data, data + lineWords, line)) {
+        return nullptr;
+    }
+
+    if (entry != head) {
+        unlink(entry);
+        pushFront(entry);
+    }
+    return &entries[entry].result;
+}
+
+void
+Memo::insert(const uint64_t* data, const Result& result)
+{
+    const uint64_t h = hash(data);
+    unsigned entry;
+    const auto it = index.find(h);
+    if (it != index.end()) {
+        // Either the line is already there, or it collides with the line
+        // being inserted, which replaces it
+        entry = it->second;
+        unlink(entry);
+    } else if (numValid < entries.size()) {
+        entry = numValid++;
+        index.emplace(h, entry);
+    } else {
+        // Replace the least recently used line. Its node in the index is
+        // reused, so that a full memo does not allocate
+        entry = tail;
+        unlink(entry);
+        auto node = index.extract(entries[entry].hash);
+        node.key() = h;
+        index.insert(std::move(node));
+    }
+
+    Entry &e = entries[entry];
+    e.hash = h;
+    e.result = result;
+    std::copy(data, data + lineWords, &lines[entry * lineWords]);
+    pushFront(entry);
+}
+
+} // namespace compression
+} // namespace gem5
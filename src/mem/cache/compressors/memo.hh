@@ -0,0 +1,147 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** @file
+ * Declaration of a bounded memo of compression results, indexed by the
+ * contents of the compressed lines.
+ */
+
+#ifndef __MEM_CACHE_COMPRESSORS_MEMO_HH__
+#define __MEM_CACHE_COMPRESSORS_MEMO_HH__
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "base/types.hh"
+
+namespace gem5
+{
+
+namespace compression
+{
+
+/**
+ * A memo of the results of a compressor, indexed by a hash of the
+ * contents of the line. Lines are stored alongside their results, so a
+ * hash collision is a miss rather than a wrong result. When it is full,
+ * the least recently used line is replaced.
+ *
+ * The memo only holds what the caches use from a compression (its size
+ * and latencies), so it is only valid for compressors whose results only
+ * depend on the contents of the line.
+ */
+class Memo
+{
+  public:
+    /** What is remembered of a compression. */
+    struct Result
+    {
+        /** Compressed size, in bits. */
+        std::size_t sizeBits;
+
+        /** Compression latency. */
+        Cycles compLat;
+
+        /** Decompression latency. */
+        Cycles decompLat;
+    };
+
+  private:
+    /** Marks the end of the LRU list. */
+    static constexpr unsigned Invalid = -1;
+
+    struct Entry
+    {
+        /** Hash of the line. */
+        uint64_t hash;
+
+        /** Result of the compression of the line. */
+        Result result;
+
+        /** Neighbours in the LRU list. */
+        unsigned prev;
+        unsigned next;
+    };
+
+    /** Size of a line, in number of 64-bit words. */
+    const std::size_t lineWords;
+
+    /** The entries. Their lines are stored contiguously in lines. */
+    std::vector<Entry> entries;
+
+    /** Contents of the lines, lineWords per entry. */
+    std::vector<uint64_t> lines;
+
+    /** Index of the entries by line hash. */
+    std::unordered_map<uint64_t, unsigned> index;
+
+    /** Number of entries in use. */
+    unsigned numValid;
+
+    /** Most and least recently used entries. */
+    unsigned head;
+    unsigned tail;
+
+    /** Hash the contents of a line. */
+    uint64_t hash(const uint64_t* data) const;
+
+    /** Unlink an entry from the LRU list. */
+    void unlink(unsigned entry);
+
+    /** Make an entry the most recently used one. */
+    void pushFront(unsigned entry);
+
+  public:
+    /**
+     * @param num_entries Maximum number of lines remembered.
+     * @param blk_size Size of a line, in bytes.
+     */
+    Memo(std::size_t num_entries, std::size_t blk_size);
+
+    /**
+     * Look for the result of the compression of a line. On a hit, the line
+     * becomes the most recently used one.
+     *
+     * @param data The contents of the line.
+     * @return The result, or nullptr if the line is not in the memo.
+     */
+    const Result* lookup(const uint64_t* data);
+
+    /**
+     * Remember the result of the compression of a line, replacing the
+     * least recently used line if the memo is full.
+     *
+     * @param data The contents of the line.
+     * @param result The result of its compression.
+     */
+    void insert(const uint64_t* data, const Result& result);
+};
+
+} // namespace compression
+} // namespace gem5
+
+#endif //__MEM_CACHE_COMPRESSORS_MEMO_HH__
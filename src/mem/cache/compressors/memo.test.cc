@@ -0,0 +1,154 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cstdint>
+
+#include "mem/cache/compressors/memo.hh"
+
+using namespace gem5;
+
+namespace
+{
+
+/** Lines of two 64-bit words. */
+constexpr std::size_t blkSize = 16;
+using Line = std::array<uint64_t, blkSize / sizeof(uint64_t)>;
+
+compression::Memo::Result
+makeResult(std::size_t size_bits)
+{
+    return {size_bits, Cycles(size_bits + 1), Cycles(size_bits + 2)};
+}
+
+void
+expectHit(compression::Memo &memo, const Line &line, std::size_t size_bits)
+{
+    const compression::Memo::Result *result = memo.lookup(line.data());
+    ASSERT_NE(result, nullptr);
+    EXPECT_EQ(result->sizeBits, size_bits);
+    EXPECT_EQ(result->compLat, Cycles(size_bits + 1));
+    EXPECT_EQ(result->decompLat, Cycles(size_bits + 2));
+}
+
+/** One step of Memo::hash. */
+uint64_t
+mix(uint64_t h, uint64_t word)
+{
+    h = (h ^ word) * 0x9e3779b97f4a7c15;
+    return h ^ (h >> 32);
+}
+
+/**
+ * Build a line that differs from the given one but has the same hash.
+ * Every step of the hash is a bijection, so picking the second word to
+ * cancel the difference in the first one gives a collision.
+ */
+Line
+collidingLine(const Line &line)
+{
+    const uint64_t words = Line().size();
+    const uint64_t first = line[0] + 1;
+    return {first, line[1] ^ mix(words, line[0]) ^ mix(words, first)};
+}
+
+} // anonymous namespace
+
+/** The least recently used line is replaced when the memo is full. */
+TEST(MemoTest, LRUReplacement)
+{
+    compression::Memo memo(2, blkSize);
+    const Line a = {1, 2}, b = {3, 4}, c = {5, 6};
+
+    EXPECT_EQ(memo.lookup(a.data()), nullptr);
+    memo.insert(a.data(), makeResult(10));
+    memo.insert(b.data(), makeResult(20));
+
+    // Looking a up makes b the least recently used line
+    expectHit(memo, a, 10);
+    memo.insert(c.data(), makeResult(30));
+    EXPECT_EQ(memo.lookup(b.data()), nullptr);
+    expectHit(memo, a, 10);
+    expectHit(memo, c, 30);
+
+    // Inserting a line again updates it without evicting anything
+    memo.insert(c.data(), makeResult(40));
+    expectHit(memo, a, 10);
+    expectHit(memo, c, 40);
+}
+
+/** A line whose hash collides with a remembered one is a miss. */
+TEST(MemoTest, HashCollision)
+{
+    compression::Memo memo(2, blkSize);
+    const Line a = {1, 2};
+    const Line b = collidingLine(a);
+    ASSERT_NE(a, b);
+
+    memo.insert(a.data(), makeResult(10));
+    EXPECT_EQ(memo.lookup(b.data()), nullptr);
+    expectHit(memo, a, 10);
+
+    // The colliding line replaces the remembered one in its entry, so
+    // the other entry is still free
+    memo.insert(b.data(), makeResult(20));
+    EXPECT_EQ(memo.lookup(a.data()), nullptr);
+    expectHit(memo, b, 20);
+
+    const Line c = {5, 6};
+    memo.insert(c.data(), makeResult(30));
+    expectHit(memo, b, 20);
+    expectHit(memo, c, 30);
+}
+
+/**
+ * The entries and index nodes of evicted lines are reused by the lines
+ * replacing them, and an evicted line can be inserted again.
+ */
+TEST(MemoTest, ReuseAfterEviction)
+{
+    compression::Memo memo(2, blkSize);
+
+    for (uint64_t i = 0; i < 100; i++) {
+        const Line line = {i, ~i};
+        memo.insert(line.data(), makeResult(i));
+        // Leave the previous line as the least recently used one
+        if (i >= 1) {
+            expectHit(memo, Line{i - 1, ~(i - 1)}, i - 1);
+        }
+        expectHit(memo, line, i);
+        if (i >= 2) {
+            EXPECT_EQ(memo.lookup(Line{i - 2, ~(i - 2)}.data()), nullptr);
+        }
+    }
+
+    const Line evicted = {0, ~uint64_t(0)};
+    memo.insert(evicted.data(), makeResult(1000));
+    expectHit(memo, evicted, 1000);
+    expectHit(memo, Line{99, ~uint64_t(99)}, 99);
+    EXPECT_EQ(memo.lookup(Line{98, ~uint64_t(98)}.data()), nullptr);
+}
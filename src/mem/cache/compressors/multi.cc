@@ -69,6 +69,9 @@ Multi::Multi(const Params &p)
     multiStats(stats, *this)
 {
     fatal_if(compressors.size() == 0, "There must be at least one compressor");
+    fatal_if(memo != nullptr && !memoizable(), "The results of a multi "
+        "compressor cannot be memoized if those of a sub-compressor "
+        "cannot.");
 }
 
 Multi::~Multi()
@@ -78,6 +81,17 @@ Multi::~Multi()
     }
 }
 
+bool
+Multi::memoizable() const
+{
+    for (const auto& compressor : compressors) {
+        if (!compressor->memoizable()) {
+            return false;
+        }
+    }
+    return true;
+}
+
 void
 Multi::setCache(BaseCache *_cache)
 {
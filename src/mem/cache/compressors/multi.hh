@@ -108,6 +108,8 @@ class Multi : public Base
 
     void setCache(BaseCache *_cache) override;
 
+    bool memoizable() const override;
+
     std::unique_ptr<Base::CompressionData> compress(
         const std::vector<Base::Chunk>& chunks,
         Cycles& comp_lat, Cycles& decomp_lat) override;
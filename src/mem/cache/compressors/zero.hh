@@ -88,11 +88,12 @@ class Zero : public DictionaryCompressor<uint64_t>
         return pattern_names[number];
     };
 
-    std::unique_ptr<Pattern>
+    Pattern*
     getPattern(const DictionaryEntry& bytes, const DictionaryEntry& dict_bytes,
-        const int match_location) const override
+        const int match_location, PatternSlot& slot) const override
     {
-        return PatternFactory::getPattern(bytes, dict_bytes, match_location);
+        return PatternFactory::getPattern(bytes, dict_bytes, match_location,
+            slot);
     }
 
     void addToDictionary(DictionaryEntry data) override;
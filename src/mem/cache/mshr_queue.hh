@@ -77,9 +77,11 @@ class MSHRQueue : public Queue<MSHR>
      * any access.
      * @param demand_reserve The minimum number of entries needed to satisfy
      * demand accesses.
+     * @param indexed Whether to index the MSHRs by block address.
      */
     MSHRQueue(const std::string &_label, int num_entries, int reserve,
-              int demand_reserve, std::string cache_name);
+              int demand_reserve, std::string cache_name,
+              bool indexed = false);
 
     /**
      * Allocates a new MSHR for the request and size. This places the request
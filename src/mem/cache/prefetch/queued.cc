@@ -38,6 +38,7 @@
 #include "mem/cache/prefetch/queued.hh"
 
 #include <cassert>
+#include <iterator>
 
 #include "arch/generic/tlb.hh"
 #include "base/logging.hh"
@@ -98,6 +99,75 @@ Queued::DeferredPacket::finish(const Fault &fault,
     owner->translationComplete(this, failed);
 }
 
+std::unordered_multimap<Addr, Queued::DeferredQueue::iterator>::const_iterator
+Queued::DeferredQueue::locate(const DeferredPacket *dp) const
+{
+    auto range = byAddr.equal_range(dp->pfInfo.getAddr());
+    for (auto it = range.first; it != range.second; it++) {
+        if (&*it->second == dp) {
+            return it;
+        }
+    }
+    panic("Deferred packet for %#x is not queued.", dp->pfInfo.getAddr());
+}
+
+Queued::DeferredPacket &
+Queued::DeferredQueue::lowest() const
+{
+    assert(!empty());
+
+    // The oldest packet of the lowest priority is the first one with it
+    const int32_t priority = (*order.rbegin())->priority;
+    return **order.lower_bound(Key(priority, 0));
+}
+
+Queued::DeferredPacket &
+Queued::DeferredQueue::push(const DeferredPacket &dp)
+{
+    iterator it = packets.insert(packets.end(), dp);
+    it->seq = nextSeq++;
+    order.insert(it);
+    byAddr.emplace(it->pfInfo.getAddr(), it);
+    return *it;
+}
+
+void
+Queued::DeferredQueue::erase(DeferredPacket *dp)
+{
+    auto addr_it = locate(dp);
+    iterator it = addr_it->second;
+    byAddr.erase(addr_it);
+    order.erase(it);
+    packets.erase(it);
+}
+
+Queued::DeferredPacket *
+Queued::DeferredQueue::find(const PrefetchInfo &pfi) const
+{
+    const Order before;
+    bool found = false;
+    iterator first;
+    auto range = byAddr.equal_range(pfi.getAddr());
+    for (auto it = range.first; it != range.second; it++) {
+        const iterator &dp = it->second;
+        if (dp->pfInfo.sameAddr(pfi) && (!found || before(dp, first))) {
+            first = dp;
+            found = true;
+        }
+    }
+    return found ? &*first : nullptr;
+}
+
+void
+Queued::DeferredQueue::promote(DeferredPacket *dp, int32_t priority)
+{
+    iterator it = locate(dp)->second;
+    order.erase(it);
+    it->priority = priority;
+    it->seq = nextSeq++;
+    order.insert(it);
+}
+
 Queued::Queued(const QueuedPrefetcherParams &p)
     : Base(p), queueSize(p.queue_size),
       missingTranslationQueueSize(
@@ -112,13 +182,13 @@ Queued::Queued(const QueuedPrefetcherParams &p)
 Queued::~Queued()
 {
     // Delete the queued prefetch packets
-    for (DeferredPacket &p : pfq) {
-        delete p.pkt;
+    for (const auto &dp : pfq) {
+        delete dp->pkt;
     }
 }
 
 void
-Queued::printQueue(const std::list<DeferredPacket> &queue) const
+Queued::printQueue(const DeferredQueue &queue) const
 {
     int pos = 0;
     std::string queue_name = "";
@@ -129,13 +199,13 @@ Queued::printQueue(const std::list<DeferredPacket> &queue) const
         queue_name = "PFTransQ";
     }
 
-    for (const_iterator it = queue.cbegin(); it != queue.cend();
-                                                            it++, pos++) {
-        Addr vaddr = it->pfInfo.getAddr();
+    for (const auto &dp : queue) {
+        Addr vaddr = dp->pfInfo.getAddr();
         /* Set paddr to 0 if not yet translated */
-        Addr paddr = it->pkt ? it->pkt->getAddr() : 0;
+        Addr paddr = dp->pkt ? dp->pkt->getAddr() : 0;
         DPRINTF(HWPrefetchQueue, "%s[%d]: Prefetch Req VA: %#x PA: %#x "
-                "prio: %3d\n", queue_name, pos, vaddr, paddr, it->priority);
+                "prio: %3d\n", queue_name, pos, vaddr, paddr, dp->priority);
+        pos++;
     }
 }
 
@@ -177,19 +247,18 @@ Queued::notify(const PacketPtr &pkt, const PrefetchInfo &pfi)
 
     // Squash queued prefetches if demand miss to same line
     if (queueSquash) {
-        auto itr = pfq.begin();
-        while (itr != pfq.end()) {
-            if (itr->pfInfo.getAddr() == blk_addr &&
-                itr->pfInfo.isSecure() == is_secure) {
+        auto range = pfq.equalRange(blk_addr);
+        auto itr = range.first;
+        while (itr != range.second) {
+            DeferredPacket &dp = *(itr++)->second;
+            if (dp.pfInfo.isSecure() == is_secure) {
                 DPRINTF(HWPrefetch, "Removing pf candidate addr: %#x "
                         "(cl: %#x), demand request going to the same addr\n",
-                        itr->pfInfo.getAddr(),
-                        blockAddress(itr->pfInfo.getAddr()));
-                delete itr->pkt;
-                itr = pfq.erase(itr);
+                        dp.pfInfo.getAddr(),
+                        blockAddress(dp.pfInfo.getAddr()));
+                delete dp.pkt;
+                pfq.erase(&dp);
                 statsQueued.pfRemovedDemand++;
-            } else {
-                ++itr;
             }
         }
     }
@@ -251,7 +320,7 @@ Queued::getPacket()
     }
 
     PacketPtr pkt = pfq.front().pkt;
-    pfq.pop_front();
+    pfq.erase(&pfq.front());
 
     prefetchStats.pfIssued++;
     issuedPrefetches += 1;
@@ -287,9 +356,9 @@ void
 Queued::processMissingTranslations(unsigned max)
 {
     unsigned count = 0;
-    iterator it = pfqMissingTranslation.begin();
+    auto it = pfqMissingTranslation.begin();
     while (it != pfqMissingTranslation.end() && count < max) {
-        DeferredPacket &dp = *it;
+        DeferredPacket &dp = **it;
         // Increase the iterator first because dp.startTranslation can end up
         // calling finishTranslation, which will erase "it"
         it++;
@@ -301,73 +370,53 @@ Queued::processMissingTranslations(unsigned max)
 void
 Queued::translationComplete(DeferredPacket *dp, bool failed)
 {
-    auto it = pfqMissingTranslation.begin();
-    while (it != pfqMissingTranslation.end()) {
-        if (&(*it) == dp) {
-            break;
-        }
-        it++;
-    }
-    assert(it != pfqMissingTranslation.end());
     if (!failed) {
         DPRINTF(HWPrefetch, "%s Translation of vaddr %#x succeeded: "
                 "paddr %#x \n", tlb->name(),
-                it->translationRequest->getVaddr(),
-                it->translationRequest->getPaddr());
-        Addr target_paddr = it->translationRequest->getPaddr();
+                dp->translationRequest->getVaddr(),
+                dp->translationRequest->getPaddr());
+        Addr target_paddr = dp->translationRequest->getPaddr();
         // check if this prefetch is already redundant
-        if (cacheSnoop && (inCache(target_paddr, it->pfInfo.isSecure()) ||
-                    inMissQueue(target_paddr, it->pfInfo.isSecure()))) {
+        if (cacheSnoop && (inCache(target_paddr, dp->pfInfo.isSecure()) ||
+                    inMissQueue(target_paddr, dp->pfInfo.isSecure()))) {
             statsQueued.pfInCache++;
             DPRINTF(HWPrefetch, "Dropping redundant in "
                     "cache/MSHR prefetch addr:%#x\n", target_paddr);
         } else {
             Tick pf_time = curTick() + clockPeriod() * latency;
-            it->createPkt(target_paddr, blkSize, requestorId, tagPrefetch,
+            dp->createPkt(target_paddr, blkSize, requestorId, tagPrefetch,
                           pf_time);
-            addToQueue(pfq, *it);
+            addToQueue(pfq, *dp);
         }
     } else {
         DPRINTF(HWPrefetch, "%s Translation of vaddr %#x failed, dropping "
                 "prefetch request %#x \n", tlb->name(),
-                it->translationRequest->getVaddr());
+                dp->translationRequest->getVaddr());
     }
-    pfqMissingTranslation.erase(it);
+    pfqMissingTranslation.erase(dp);
 }
 
 bool
-Queued::alreadyInQueue(std::list<DeferredPacket> &queue,
+Queued::alreadyInQueue(DeferredQueue &queue,
                                  const PrefetchInfo &pfi, int32_t priority)
 {
-    bool found = false;
-    iterator it;
-    for (it = queue.begin(); it != queue.end() && !found; it++) {
-        found = it->pfInfo.sameAddr(pfi);
+    DeferredPacket *dp = queue.find(pfi);
+    if (dp == nullptr) {
+        return false;
     }
 
-    /* If the address is already in the queue, update priority and leave */
-    if (it != queue.end()) {
-        statsQueued.pfBufferHit++;
-        if (it->priority < priority) {
-            /* Update priority value and position in the queue */
-            it->priority = priority;
-            iterator prev = it;
-            while (prev != queue.begin()) {
-                prev--;
-                /* If the packet has higher priority, swap */
-                if (*it > *prev) {
-                    std::swap(*it, *prev);
-                    it = prev;
-                }
-            }
-            DPRINTF(HWPrefetch, "Prefetch addr already in "
-                "prefetch queue, priority updated\n");
-        } else {
-            DPRINTF(HWPrefetch, "Prefetch addr already in "
-                "prefetch queue\n");
-        }
+    /* The address is already in the queue, update priority and leave */
+    statsQueued.pfBufferHit++;
+    if (dp->priority < priority) {
+        /* Update priority value and position in the queue */
+        queue.promote(dp, priority);
+        DPRINTF(HWPrefetch, "Prefetch addr already in "
+            "prefetch queue, priority updated\n");
+    } else {
+        DPRINTF(HWPrefetch, "Prefetch addr already in "
+            "prefetch queue\n");
     }
-    return found;
+    return true;
 }
 
 RequestPtr
@@ -481,50 +530,23 @@ Queued::insert(const PacketPtr &pkt, PrefetchInfo &new_pfi,
 }
 
 void
-Queued::addToQueue(std::list<DeferredPacket> &queue,
-                             DeferredPacket &dpp)
+Queued::addToQueue(DeferredQueue &queue, DeferredPacket &dpp)
 {
     /* Verify prefetch buffer space for request */
     if (queue.size() == queueSize) {
         statsQueued.pfRemovedFull++;
-        /* Lowest priority packet */
-        iterator it = queue.end();
-        panic_if (it == queue.begin(),
-            "Prefetch queue is both full and empty!");
-        --it;
-        /* Look for oldest in that level of priority */
-        panic_if (it == queue.begin(),
-            "Prefetch queue is full with 1 element!");
-        iterator prev = it;
-        bool cont = true;
-        /* While not at the head of the queue */
-        while (cont && prev != queue.begin()) {
-            prev--;
-            /* While at the same level of priority */
-            cont = prev->priority == it->priority;
-            if (cont)
-                /* update pointer */
-                it = prev;
-        }
+        panic_if(queue.empty(), "Prefetch queue is both full and empty!");
+        panic_if(queue.size() == 1, "Prefetch queue is full with 1 element!");
+        /* Oldest packet of the lowest priority */
+        DeferredPacket &lowest = queue.lowest();
         DPRINTF(HWPrefetch, "Prefetch queue full, removing lowest priority "
-                            "oldest packet, addr: %#x\n",it->pfInfo.getAddr());
-        delete it->pkt;
-        queue.erase(it);
+                            "oldest packet, addr: %#x\n",
+                            lowest.pfInfo.getAddr());
+        delete lowest.pkt;
+        queue.erase(&lowest);
     }
 
-    if ((queue.size() == 0) || (dpp <= queue.back())) {
-        queue.emplace_back(dpp);
-    } else {
-        iterator it = queue.end();
-        do {
-            --it;
-        } while (it != queue.begin() && dpp > *it);
-        /* If we reach the head, we have to see if the new element is new head
-         * or not */
-        if (it == queue.begin() && dpp <= *it)
-            it++;
-        queue.insert(it, dpp);
-    }
+    queue.push(dpp);
 
     if (debug::HWPrefetchQueue)
         printQueue(queue);
@@ -40,6 +40,8 @@
 
 #include <cstdint>
 #include <list>
+#include <set>
+#include <unordered_map>
 #include <utility>
 
 #include "arch/generic/mmu.hh"
@@ -72,6 +74,11 @@ class Queued : public Base
         PacketPtr pkt;
         /** The priority of this prefetch */
         int32_t priority;
+        /**
+         * Order of insertion in its queue, which sorts prefetches of the
+         * same priority
+         */
+        uint64_t seq;
         /** Request used when a translation is needed */
         RequestPtr translationRequest;
         ThreadContext *tc;
@@ -87,7 +94,7 @@ class Queued : public Base
          */
         DeferredPacket(Queued *o, PrefetchInfo const &pfi, Tick t,
             int32_t prio) : owner(o), pfInfo(pfi), tick(t), pkt(nullptr),
-            priority(prio), translationRequest(), tc(nullptr),
+            priority(prio), seq(0), translationRequest(), tc(nullptr),
             ongoingTranslation(false) {
         }
 
@@ -140,11 +147,127 @@ class Queued : public Base
         void startTranslation(BaseTLB *tlb);
     };
 
-    std::list<DeferredPacket> pfq;
-    std::list<DeferredPacket> pfqMissingTranslation;
+    /**
+     * A queue of deferred packets, sorted by decreasing priority, and from
+     * oldest to newest within a priority. The packets are also indexed by
+     * address, so that finding, promoting, inserting and removing a packet
+     * are logarithmic, rather than linear, in the size of the queue.
+     */
+    class DeferredQueue
+    {
+      private:
+        using iterator = std::list<DeferredPacket>::iterator;
+
+        /** Priority and insertion order of a packet. */
+        using Key = std::pair<int32_t, uint64_t>;
+
+        /**
+         * Sorts packets by decreasing priority, then by age. Packets can be
+         * compared to keys, to look up the first packet of a priority.
+         */
+        struct Order
+        {
+            using is_transparent = void;
+
+            static Key key(const iterator &it)
+            {
+                return Key(it->priority, it->seq);
+            }
+            static Key key(const Key &key) { return key; }
+
+            template <class A, class B>
+            bool
+            operator()(const A &a, const B &b) const
+            {
+                const Key key_a = key(a);
+                const Key key_b = key(b);
+                return key_a.first != key_b.first ?
+                    key_a.first > key_b.first : key_a.second < key_b.second;
+            }
+        };
+
+        /**
+         * The packets. They never move once queued, as translations in
+         * flight point to them.
+         */
+        std::list<DeferredPacket> packets;
+
+        /** The packets in queue order. */
+        std::set<iterator, Order> order;
+
+        /** The packets, by address. */
+        std::unordered_multimap<Addr, iterator> byAddr;
+
+        /** Insertion order of the next packet. */
+        uint64_t nextSeq;
+
+        /** Find the address index entry of a queued packet. */
+        std::unordered_multimap<Addr, iterator>::const_iterator
+        locate(const DeferredPacket *dp) const;
+
+      public:
+        using const_iterator = std::set<iterator, Order>::const_iterator;
+
+        DeferredQueue() : nextSeq(0) {}
+
+        std::size_t size() const { return packets.size(); }
+        bool empty() const { return packets.empty(); }
+
+        /** The packets, in queue order; dereferencing yields an iterator. */
+        const_iterator begin() const { return order.begin(); }
+        const_iterator end() const { return order.end(); }
+
+        /** The packet with the highest priority, the oldest on ties. */
+        DeferredPacket &front() const { return **order.begin(); }
+
+        /** The packet with the lowest priority, the oldest on ties. */
+        DeferredPacket &lowest() const;
+
+        /**
+         * Queue a copy of a packet behind the packets of equal or higher
+         * priority.
+         *
+         * @param dp The packet to queue.
+         * @return The queued packet.
+         */
+        DeferredPacket &push(const DeferredPacket &dp);
+
+        /** Remove a queued packet. */
+        void erase(DeferredPacket *dp);
+
+        /**
+         * Find the first packet in queue order with the address of a
+         * prefetch.
+         *
+         * @param pfi The prefetch.
+         * @return The packet, or nullptr if there is none.
+         */
+        DeferredPacket *find(const PrefetchInfo &pfi) const;
+
+        /**
+         * Raise the priority of a queued packet. It moves behind the
+         * packets of equal or higher priority.
+         *
+         * @param dp The queued packet.
+         * @param priority The new priority.
+         */
+        void promote(DeferredPacket *dp, int32_t priority);
+
+        /**
+         * Find the packets of a block address, of any security state.
+         *
+         * @param addr The block address.
+         * @return A pair of iterators of (address, iterator) pairs.
+         */
+        auto
+        equalRange(Addr addr) const
+        {
+            return byAddr.equal_range(addr);
+        }
+    };
 
-    using const_iterator = std::list<DeferredPacket>::const_iterator;
-    using iterator = std::list<DeferredPacket>::iterator;
+    DeferredQueue pfq;
+    DeferredQueue pfqMissingTranslation;
 
     // PARAMETERS
 
@@ -206,7 +329,7 @@ class Queued : public Base
         return pfq.empty() ? MaxTick : pfq.front().tick;
     }
 
-    void printQueue(const std::list<DeferredPacket> &queue) const;
+    void printQueue(const DeferredQueue &queue) const;
 
   private:
 
@@ -215,7 +338,7 @@ class Queued : public Base
      * @param queue selected queue to use
      * @param dpp DeferredPacket to add
      */
-    void addToQueue(std::list<DeferredPacket> &queue, DeferredPacket &dpp);
+    void addToQueue(DeferredQueue &queue, DeferredPacket &dpp);
 
     /**
      * Starts the translations of the queued prefetches with a
@@ -243,7 +366,7 @@ class Queued : public Base
      * @param priority priority of the prefetch request to be added
      * @return True if the prefetch request was found in the queue
      */
-    bool alreadyInQueue(std::list<DeferredPacket> &queue,
+    bool alreadyInQueue(DeferredQueue &queue,
                         const PrefetchInfo &pfi, int32_t priority);
 
     /**
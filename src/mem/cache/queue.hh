@@ -45,10 +45,13 @@
 #ifndef __MEM_CACHE_QUEUE_HH__
 #define __MEM_CACHE_QUEUE_HH__
 
+#include <algorithm>
 #include <cassert>
 #include <string>
 #include <type_traits>
+#include <vector>
 
+#include "base/intmath.hh"
 #include "base/logging.hh"
 #include "base/named.hh"
 #include "base/trace.hh"
@@ -101,6 +104,96 @@ class Queue : public Drainable, public Named
     /** Holds non allocated entries. */
     typename Entry::List freeList;
 
+    /**
+     * Optional index of the allocated entries by block address. Each
+     * bucket holds its entries in allocation order, that is, in the order
+     * of allocatedList, so lookups find the same entry as a scan of the
+     * whole list. Empty when the queue is not indexed.
+     */
+    std::vector<std::vector<Entry*>> buckets;
+
+    /** Number of bits of the bucket index. */
+    unsigned bucketBits;
+
+    /**
+     * Get the bucket of the index that holds the entries of an address.
+     *
+     * @param blk_addr The block address.
+     * @return The bucket of the address.
+     */
+    std::vector<Entry*>&
+    bucket(Addr blk_addr)
+    {
+        // Fibonacci hashing, as block addresses have their low bits clear
+        return buckets[(blk_addr * 0x9e3779b97f4a7c15ULL) >>
+                       (64 - bucketBits)];
+    }
+
+    const std::vector<Entry*>&
+    bucket(Addr blk_addr) const
+    {
+        return const_cast<Queue*>(this)->bucket(blk_addr);
+    }
+
+    /**
+     * Add a newly allocated entry to the index, if the queue is indexed.
+     * Must be called once the entry's address is set, after it has been
+     * appended to allocatedList.
+     *
+     * @param entry The allocated entry.
+     */
+    void
+    indexEntry(Entry *entry)
+    {
+        if (!buckets.empty()) {
+            bucket(entry->blkAddr).push_back(entry);
+        }
+    }
+
+    /**
+     * Find the first entry of a container of allocated entries that
+     * matches the provided address.
+     *
+     * @sa findMatch(Addr, bool, bool)
+     */
+    template <class Container>
+    static Entry* findMatch(const Container &candidates, Addr blk_addr,
+                            bool is_secure, bool ignore_uncacheable)
+    {
+        for (const auto& entry : candidates) {
+            // we ignore any entries allocated for uncacheable
+            // accesses and simply ignore them when matching, in the
+            // cache we never check for matches when adding new
+            // uncacheable entries, and we do not want normal
+            // cacheable accesses being added to an WriteQueueEntry
+            // serving an uncacheable access
+            if (!(ignore_uncacheable && entry->isUncacheable()) &&
+                entry->matchBlockAddr(blk_addr, is_secure)) {
+                return entry;
+            }
+        }
+        return nullptr;
+    }
+
+    /**
+     * Try to satisfy a functional access with the first entry of a
+     * container of allocated entries that holds its block.
+     */
+    template <class Container>
+    bool trySatisfyFunctional(const Container &candidates, PacketPtr pkt)
+    {
+        pkt->pushLabel(label);
+        for (const auto& entry : candidates) {
+            if (entry->matchBlockAddr(pkt) &&
+                entry->trySatisfyFunctional(pkt)) {
+                pkt->popLabel();
+                return true;
+            }
+        }
+        pkt->popLabel();
+        return false;
+    }
+
     typename Entry::Iterator addToReadyList(Entry* entry)
     {
         if (readyList.empty() ||
@@ -129,17 +222,26 @@ class Queue : public Drainable, public Named
      *
      * @param num_entries The number of entries in this queue.
      * @param reserve The extra overflow entries needed.
+     * @param indexed Whether to index the entries by block address, so
+     *        that lookups do not scan all allocated entries.
      */
     Queue(const std::string &_label, int num_entries, int reserve,
-            const std::string &name) :
+            const std::string &name, bool indexed = false) :
         Named(name),
         label(_label), numEntries(num_entries + reserve),
         numReserve(reserve), entries(numEntries, name + ".entry"),
-        _numInService(0), allocated(0)
+        bucketBits(0), _numInService(0), allocated(0)
     {
         for (int i = 0; i < numEntries; ++i) {
             freeList.push_back(&entries[i]);
         }
+
+        if (indexed) {
+            // At least twice as many buckets as entries, so that buckets
+            // rarely hold more than one address
+            bucketBits = std::max(ceilLog2(2 * numEntries), 1);
+            buckets.resize(1 << bucketBits);
+        }
     }
 
     bool isEmpty() const
@@ -168,33 +270,26 @@ class Queue : public Drainable, public Named
     Entry* findMatch(Addr blk_addr, bool is_secure,
                      bool ignore_uncacheable = true) const
     {
-        for (const auto& entry : allocatedList) {
-            // we ignore any entries allocated for uncacheable
-            // accesses and simply ignore them when matching, in the
-            // cache we never check for matches when adding new
-            // uncacheable entries, and we do not want normal
-            // cacheable accesses being added to an WriteQueueEntry
-            // serving an uncacheable access
-            if (!(ignore_uncacheable && entry->isUncacheable()) &&
-                entry->matchBlockAddr(blk_addr, is_secure)) {
-                return entry;
-            }
+        if (!buckets.empty()) {
+            return findMatch(bucket(blk_addr), blk_addr, is_secure,
+                             ignore_uncacheable);
         }
-        return nullptr;
+        return findMatch(allocatedList, blk_addr, is_secure,
+                         ignore_uncacheable);
     }
 
     bool trySatisfyFunctional(PacketPtr pkt)
     {
-        pkt->pushLabel(label);
-        for (const auto& entry : allocatedList) {
-            if (entry->matchBlockAddr(pkt) &&
-                entry->trySatisfyFunctional(pkt)) {
-                pkt->popLabel();
-                return true;
+        if (!buckets.empty()) {
+            // All the entries have the block size of the cache
+            if (allocatedList.empty()) {
+                return false;
             }
+            const unsigned blk_size = allocatedList.front()->blkSize;
+            return trySatisfyFunctional(bucket(pkt->getBlockAddr(blk_size)),
+                                        pkt);
         }
-        pkt->popLabel();
-        return false;
+        return trySatisfyFunctional(allocatedList, pkt);
     }
 
     /**
@@ -241,6 +336,11 @@ class Queue : public Drainable, public Named
     deallocate(Entry *entry)
     {
         allocatedList.erase(entry->allocIter);
+        if (!buckets.empty()) {
+            std::vector<Entry*> &entry_bucket = bucket(entry->blkAddr);
+            entry_bucket.erase(std::find(entry_bucket.begin(),
+                                         entry_bucket.end(), entry));
+        }
         freeList.push_front(entry);
         allocated--;
         if (entry->inService) {
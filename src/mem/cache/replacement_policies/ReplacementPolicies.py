@@ -150,19 +150,55 @@ class WeightedLRURP(LRURP):
     cxx_class = 'gem5::replacement_policy::WeightedLRU'
     cxx_header = "mem/cache/replacement_policies/weighted_lru_rp.hh"
 
+# Implementation of the OPTgen occupancy vector used by Hawkeye
+class OPTgenBackend(ScopedEnum):
+    """
+    linear: walk the occupancy vector on every decision, O(history)
+    segment_tree: lazy max-segment-tree over the occupancy vector,
+        O(log history)
+    """
+    vals = ['linear', 'segment_tree']
+
+# Hash used to index Hawkeye's SHCT with the PC
+class HawkeyeSHCTHash(ScopedEnum):
+    """
+    modulo: PC modulo the number of SHCT entries
+    xor_fold: XOR of the 16-bit chunks of the PC, modulo the number of SHCT
+        entries
+    """
+    vals = ['modulo', 'xor_fold']
+
 # TODO: class def for Hawkeye
 class HawkeyeRP(BaseReplacementPolicy):
     type = "HawkeyeRP"
     cxx_class = 'gem5::replacement_policy::Hawkeye'
     cxx_header = "mem/cache/replacement_policies/hawkeye_rp.hh"
 
-    cache_line_size = Param.Int(Parent.cache_line_size, "block size in bytes")
-    llc_sets = Param.Unsigned(16384, "Number of LLC sets")
-    llc_ways = Param.Unsigned(16, "Number of LLC ways")
+    # The number of sets and ways is taken from the positions of the
+    # entries the tags instantiate
 
     max_rrpv = Param.Unsigned(7, "Max RRPV")
     shct_size = Param.Unsigned(16384, "Number of SHCT entries")
     max_shct = Param.Unsigned(31, "Max SHCT value")
+    shct_hash = Param.HawkeyeSHCTHash('modulo',
+        "Hash of the PC used to index the SHCT")
+    shct_fold_requestor = Param.Bool(False,
+        "Fold the requestor ID into the SHCT index")
+
+    # Multi-core mode: every core trains and reads its own predictor, so
+    # cores do not thrash a shared SHCT. The context ID of an access is its
+    # core, so every context must be below num_cores; a single core shares
+    # its predictor with all of them.
+    num_cores = Param.Unsigned(1, "Number of cores with a private predictor")
+    prefetch_predictor = Param.Bool(False,
+        "Train and predict hardware prefetches with their own predictor")
 
     # One occupancy vector for each cache set --> each 128 entries
     occupancy_vec_size = Param.Unsigned(128, "Size of Occupancy Vector")
+    optgen_backend = Param.OPTgenBackend('linear',
+        "Implementation of the OPTgen occupancy vector")
+
+    # Only the sampled sets run OPTgen and train the predictor; the other
+    # sets just read it. 0 samples every set.
+    sampled_sets = Param.Unsigned(0,
+        "Number of sets that run OPTgen and train the predictor")
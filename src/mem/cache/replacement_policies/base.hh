@@ -29,7 +29,11 @@
 #ifndef __MEM_CACHE_REPLACEMENT_POLICIES_BASE_HH__
 #define __MEM_CACHE_REPLACEMENT_POLICIES_BASE_HH__
 
+#include <algorithm>
+#include <cstddef>
 #include <memory>
+#include <utility>
+#include <vector>
 
 #include "base/compiler.hh"
 #include "mem/cache/replacement_policies/replaceable_entry.hh"
@@ -49,6 +53,61 @@ GEM5_DEPRECATED_NAMESPACE(ReplacementPolicy, replacement_policy);
 namespace replacement_policy
 {
 
+/**
+ * Storage of the replacement data of the entries of a policy. The data are
+ * constructed in place in large contiguous chunks, instead of with one heap
+ * allocation and one control block each. The shared pointers handed to the
+ * entries alias the chunks and share their single control block, so the
+ * chunks live as long as any entry points to them. Each entry still holds
+ * a full shared pointer, and every copy of it updates the shared count.
+ *
+ * @tparam Data The type of the replacement data of an entry.
+ */
+template <class Data>
+class ReplacementDataPool
+{
+  private:
+    /** Number of data of the first chunk. */
+    static constexpr std::size_t minChunkSize = 16;
+
+    /** Maximum number of data of a chunk; each chunk doubles the last. */
+    static constexpr std::size_t maxChunkSize = 4096;
+
+    typedef std::vector<std::vector<Data>> Chunks;
+
+    /**
+     * The chunks. A chunk never grows beyond the capacity it is reserved
+     * with, so the data never move once constructed.
+     */
+    std::shared_ptr<Chunks> chunks;
+
+  public:
+    ReplacementDataPool() : chunks(std::make_shared<Chunks>()) {}
+
+    /**
+     * Construct the replacement data of a new entry.
+     *
+     * @param args The arguments of the constructor of the data.
+     * @return A shared pointer to the new replacement data.
+     */
+    template <typename... Args>
+    std::shared_ptr<ReplacementData>
+    allocate(Args&&... args)
+    {
+        if (chunks->empty() ||
+            chunks->back().size() == chunks->back().capacity()) {
+            const std::size_t chunk_size = chunks->empty() ? minChunkSize :
+                std::min(2 * chunks->back().capacity(), maxChunkSize);
+            chunks->emplace_back();
+            chunks->back().reserve(chunk_size);
+        }
+
+        std::vector<Data> &chunk = chunks->back();
+        chunk.emplace_back(std::forward<Args>(args)...);
+        return std::shared_ptr<ReplacementData>(chunks, &chunk.back());
+    }
+};
+
 /**
  * A common base class of cache replacement policy objects.
  */
@@ -95,6 +154,13 @@ class Base : public SimObject
     virtual void reset(const std::shared_ptr<ReplacementData>&
         replacement_data) const = 0;
 
+    /**
+     * Whether the policy learns from the packets given to touch() and
+     * reset(). Callers that have no packet at hand only need to build one
+     * for these policies.
+     */
+    virtual bool needsPacket() const { return false; }
+
     /**
      * Find replacement victim among candidates.
      *
@@ -110,6 +176,21 @@ class Base : public SimObject
      * @return A shared pointer to the new replacement data.
      */
     virtual std::shared_ptr<ReplacementData> instantiateEntry() = 0;
+
+    /**
+     * Instantiate a replacement data entry for the entry located at the
+     * given position of its table. Policies that keep per-set state use
+     * the position to locate it; the others ignore it.
+     *
+     * @param set The set of the entry.
+     * @param way The way of the entry.
+     * @return A shared pointer to the new replacement data.
+     */
+    virtual std::shared_ptr<ReplacementData>
+    instantiateEntry(const uint32_t set, const uint32_t way)
+    {
+        return instantiateEntry();
+    }
 };
 
 } // namespace replacement_policy
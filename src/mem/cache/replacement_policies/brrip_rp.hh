@@ -112,6 +112,10 @@ class BRRIP : public Base
      */
     const unsigned btp;
 
+  private:
+    /** Storage of the replacement data of the entries. */
+    ReplacementDataPool<BRRIPReplData> replDataPool;
+
   public:
     typedef BRRIPRPParams Params;
     BRRIP(const Params &p);
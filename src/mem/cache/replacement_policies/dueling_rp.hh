@@ -93,6 +93,10 @@ class Dueling : public Base
         statistics::Scalar selectedB;
     } duelingStats;
 
+  private:
+    /** Storage of the replacement data of the entries. */
+    ReplacementDataPool<DuelerReplData> replDataPool;
+
   public:
     PARAMS(DuelingRP);
     Dueling(const Params &p);
@@ -110,7 +114,10 @@ class Dueling : public Base
                                                                      override;
     ReplaceableEntry* getVictim(const ReplacementCandidates& candidates) const
                                                                      override;
+    bool needsPacket() const override;
     std::shared_ptr<ReplacementData> instantiateEntry() override;
+    std::shared_ptr<ReplacementData> instantiateEntry(const uint32_t set,
+        const uint32_t way) override;
 };
 
 } // namespace replacement_policy
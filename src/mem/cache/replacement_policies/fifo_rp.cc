@@ -50,8 +50,8 @@ void
 FIFO::invalidate(const std::shared_ptr<ReplacementData>& replacement_data)
 {
     // Reset insertion tick
-    std::static_pointer_cast<FIFOReplData>(
-        replacement_data)->tickInserted = Tick(0);
+    static_cast<FIFOReplData*>(
+        replacement_data.get())->tickInserted = Tick(0);
 }
 
 void
@@ -64,8 +64,8 @@ void
 FIFO::reset(const std::shared_ptr<ReplacementData>& replacement_data) const
 {
     // Set insertion tick
-    std::static_pointer_cast<FIFOReplData>(
-        replacement_data)->tickInserted = curTick();
+    static_cast<FIFOReplData*>(
+        replacement_data.get())->tickInserted = curTick();
 }
 
 ReplaceableEntry*
@@ -78,10 +78,10 @@ FIFO::getVictim(const ReplacementCandidates& candidates) const
     ReplaceableEntry* victim = candidates[0];
     for (const auto& candidate : candidates) {
         // Update victim entry if necessary
-        if (std::static_pointer_cast<FIFOReplData>(
-                    candidate->replacementData)->tickInserted <
-                std::static_pointer_cast<FIFOReplData>(
-                    victim->replacementData)->tickInserted) {
+        if (static_cast<FIFOReplData*>(
+                    candidate->replacementData.get())->tickInserted <
+                static_cast<FIFOReplData*>(
+                    victim->replacementData.get())->tickInserted) {
             victim = candidate;
         }
     }
@@ -92,7 +92,7 @@ FIFO::getVictim(const ReplacementCandidates& candidates) const
 std::shared_ptr<ReplacementData>
 FIFO::instantiateEntry()
 {
-    return std::shared_ptr<ReplacementData>(new FIFOReplData());
+    return replDataPool.allocate();
 }
 
 } // namespace replacement_policy
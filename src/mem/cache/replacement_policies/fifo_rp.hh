@@ -63,6 +63,10 @@ class FIFO : public Base
         FIFOReplData() : tickInserted(0) {}
     };
 
+  private:
+    /** Storage of the replacement data of the entries. */
+    ReplacementDataPool<FIFOReplData> replDataPool;
+
   public:
     typedef FIFORPParams Params;
     FIFO(const Params &p);
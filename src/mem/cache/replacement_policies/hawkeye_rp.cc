@@ -1,6 +1,10 @@
 #include "mem/cache/replacement_policies/hawkeye_rp.hh"
 
+#include <algorithm>
+#include <iterator>
+
 #include "base/intmath.hh"
+#include "base/logging.hh"
 #include "debug/HawkeyeRP.hh"
 #include "params/HawkeyeRP.hh"
 
@@ -14,69 +18,190 @@ namespace replacement_policy
 
 Hawkeye::Hawkeye(const Params &p)
     : Base(p),
-      predictor(p.max_shct, p.shct_size),
-      num_sets(p.llc_sets),
-      num_ways(p.llc_ways),
-      cache_line_size(p.cache_line_size),
-      occupancy_vec_size(p.occupancy_vec_size)
+      num_cores(p.num_cores),
+      prefetch_predictor(p.prefetch_predictor),
+      num_sets(0),
+      num_ways(0),
+      occupancy_vec_size(p.occupancy_vec_size),
+      sampled_sets(p.sampled_sets),
+      optgen_backend(p.optgen_backend),
+      sampler_stride(1),
+      stats(*this)
 {
-    rrpv.resize(num_sets);
-    for (auto &set_counters : rrpv) {
-        set_counters.resize(num_ways, SatCounter8(3, 7));
+    fatal_if(num_cores == 0, "Hawkeye needs at least one core");
+
+    const uint32_t num_predictors = num_cores + (prefetch_predictor ? 1 : 0);
+    predictors.reserve(num_predictors);
+    for (uint32_t i = 0; i < num_predictors; ++i) {
+        predictors.emplace_back(p.max_shct, p.shct_size, p.shct_hash,
+                                p.shct_fold_requestor);
     }
+}
+
+void
+Hawkeye::init()
+{
+    Base::init();
+
+    fatal_if(num_sets == 0, "Hawkeye has no entries to manage");
+    fatal_if(num_ways > maxWays, "Hawkeye supports at most %d ways",
+             maxWays);
 
-    free_ways.resize(num_sets, std::vector<bool>(num_ways, true));
+    if (sampled_sets != 0 && sampled_sets < num_sets) {
+        fatal_if(num_sets % sampled_sets != 0,
+                 "Number of sampled sets (%d) must divide the number of "
+                 "sets (%d)", sampled_sets, num_sets);
+        sampler_stride = num_sets / sampled_sets;
+    }
+    const uint32_t num_sampled_sets = num_sets / sampler_stride;
+
+    rrpv.resize(num_sets * num_ways, maxRRPV);
+
+    optgen_per_set.reserve(num_sampled_sets);
+    for (uint32_t i = 0; i < num_sampled_sets; ++i) {
+        optgen_per_set.emplace_back(num_ways, occupancy_vec_size,
+                                    optgen_backend);
+    }
+
+    global_timestamp.resize(num_sampled_sets, 0);
+}
 
-    optgen_per_set.reserve(num_sets);
-    for (uint32_t i = 0; i < num_sets; ++i) {
-        optgen_per_set.emplace_back(num_ways, occupancy_vec_size);
+Hawkeye::Predictor::Predictor(uint32_t _max_shct, uint32_t _shct_size,
+                              HawkeyeSHCTHash _hash, bool _fold_requestor)
+    : max_shct(_max_shct), shct_size(_shct_size), hash(_hash),
+      fold_requestor(_fold_requestor)
+{
+    fatal_if(max_shct != _max_shct, "Max SHCT value must fit in 8 bits");
+    fatal_if(shct_size == 0, "SHCT must have at least one entry");
+
+    // Every counter starts at the prediction threshold, so unseen
+    // signatures are predicted cache-friendly
+    CounterLine line;
+    std::fill(std::begin(line.counters), std::end(line.counters),
+              (max_shct + 1) / 2);
+    shct.resize(divCeil(shct_size, countersPerLine), line);
+}
+
+uint32_t
+Hawkeye::Predictor::signature(uint64_t pc, RequestorID requestor) const
+{
+    uint64_t key = pc;
+    if (fold_requestor) {
+        key ^= requestor;
+    }
+
+    switch (hash) {
+      case HawkeyeSHCTHash::xor_fold:
+        key ^= (key >> 16) ^ (key >> 32) ^ (key >> 48);
+        break;
+      case HawkeyeSHCTHash::modulo:
+      default:
+        break;
+    }
+
+    return key % shct_size;
+}
+
+void
+Hawkeye::Predictor::serialize(CheckpointOut &cp) const
+{
+    std::vector<uint8_t> counters(shct_size);
+    for (uint32_t i = 0; i < shct_size; i++) {
+        counters[i] = shct[i / countersPerLine].counters[i % countersPerLine];
     }
+    arrayParamOut(cp, "shct", counters);
+}
 
-    global_timestamp.resize(num_sets, 0);
+void
+Hawkeye::Predictor::unserialize(CheckpointIn &cp)
+{
+    std::vector<uint8_t> counters;
+    arrayParamIn(cp, "shct", counters);
+    fatal_if(counters.size() != shct_size,
+             "Checkpointed SHCT has %d entries, but %d are configured",
+             counters.size(), shct_size);
+    for (uint32_t i = 0; i < shct_size; i++) {
+        counter(i) = std::min(counters[i], max_shct);
+    }
 }
 
 bool
-Hawkeye::Predictor::get_prediction(uint64_t pc)
+Hawkeye::Predictor::get_prediction(uint32_t signature)
 {
-    if (predictor.find(pc) != predictor.end() &&
-        predictor[pc] < (max_shct + 1) / 2)
-        return false;
-    return true;
+    return counter(signature) >= (max_shct + 1) / 2;
 }
 
 void
-Hawkeye::Predictor::train(uint64_t pc)
+Hawkeye::Predictor::train(uint32_t signature)
 {
-    // init
-    if (predictor.find(pc) == predictor.end())
-        predictor[pc] = (max_shct + 1) / 2;
-
-    // update
-    if (predictor[pc] < max_shct)
-        predictor[pc]++;
-    else
-        predictor[pc] = max_shct;
+    uint8_t &shct_counter = counter(signature);
+    if (shct_counter < max_shct)
+        shct_counter++;
 }
 
 void
-Hawkeye::Predictor::detrain(uint64_t pc)
+Hawkeye::Predictor::detrain(uint32_t signature)
 {
-    // init
-    if (predictor.find(pc) == predictor.end())
-        predictor[pc] = (max_shct + 1) / 2;
+    uint8_t &shct_counter = counter(signature);
+    if (shct_counter != 0)
+        shct_counter--;
+}
 
-    // update
-    if (predictor[pc] != 0)
-        predictor[pc]--;
+uint32_t
+Hawkeye::getCore(const PacketPtr pkt) const
+{
+    // A single core shares its predictor with every context
+    if (num_cores == 1 || !pkt->req->hasContextId()) {
+        return 0;
+    }
+
+    const uint32_t context = pkt->req->contextId();
+    fatal_if(context >= num_cores, "Hawkeye got an access from context %d, "
+             "but only has predictors for %d cores", context, num_cores);
+    return context;
+}
+
+bool
+Hawkeye::isHWPrefetch(const PacketPtr pkt)
+{
+    return pkt->cmd.isHWPrefetch() ||
+        pkt->req->taskId() == context_switch_task_id::Prefetcher;
+}
+
+uint32_t
+Hawkeye::getPredictorIndex(const PacketPtr pkt) const
+{
+    if (prefetch_predictor && isHWPrefetch(pkt)) {
+        return num_cores;
+    }
+    return getCore(pkt);
+}
+
+void
+Hawkeye::assignPredictor(HawkeyeReplData *repl_data, const PacketPtr pkt)
+{
+    repl_data->predictor_index = getPredictorIndex(pkt);
+    repl_data->signature = predictors[repl_data->predictor_index].signature(
+        pkt->req->hasPC() ? pkt->req->getPC() : 0, pkt->requestorId());
+}
+
+void
+Hawkeye::ageSet(uint32_t set) const
+{
+    // Branch-free saturating increment, so that the compiler can turn it
+    // into a single vector add over the set
+    uint8_t *set_rrpv = setRRPV(set);
+    for (uint32_t i = 0; i < num_ways; i++) {
+        set_rrpv[i] += set_rrpv[i] < maxRRPV - 1;
+    }
 }
 
 void
 Hawkeye::invalidate(const std::shared_ptr<ReplacementData> &replacement_data)
 {
     auto repl_data =
-        std::static_pointer_cast<HawkeyeReplData>(replacement_data);
-    free_ways[repl_data->getSet()][repl_data->getWay()] = true;
-    rrpv[repl_data->getSet()][repl_data->getWay()].saturate();
+        static_cast<HawkeyeReplData *>(replacement_data.get());
+    setRRPV(repl_data->getSet())[repl_data->getWay()] = maxRRPV;
 }
 
 void
@@ -92,46 +217,65 @@ Hawkeye::touch(const std::shared_ptr<ReplacementData> &replacement_data,
     uint32_t prev_timestamp;
     uint32_t curr_timestamp;
     uint32_t index;
-    bool opt_hit;
+    uint32_t sampler_index;
+    bool opt_hit = true;
     bool cache_friendly;
 
     auto casted_replacement_data =
-        std::static_pointer_cast<HawkeyeReplData>(replacement_data);
+        static_cast<HawkeyeReplData*>(replacement_data.get());
 
-    // std::cout << "TOUCHING Set " << casted_replacement_data->getSet() << "
-    // Way " << casted_replacement_data->getWay() << std::endl;
-
-    // Get previous timestamp using replacement data
-    prev_timestamp = casted_replacement_data->load_timestamp;
+    // Writebacks have neither a PC nor a core, and do not count as uses
+    // of the line
+    if (pkt->isWriteback()) {
+        stats.writebackHits++;
+        return;
+    }
 
-    // Get current timestamp using global timestamp vector at index given by
-    // pkt
     index = casted_replacement_data->getSet();
-    curr_timestamp = global_timestamp[index];
-    global_timestamp[index] =
-        (global_timestamp[index] + 1) % occupancy_vec_size;
-    casted_replacement_data->load_timestamp = global_timestamp[index];
 
-    optgen_per_set[index].add_cache_access(curr_timestamp);
+    // Only sampled sets run OPTgen; a hit in any other set is treated as
+    // an OPT hit, so it does not age the set
+    if (isSampled(index)) {
+        // Get previous timestamp using replacement data
+        prev_timestamp = casted_replacement_data->load_timestamp;
+
+        // Get current timestamp using the sampled set's global timestamp
+        sampler_index = samplerIndex(index);
+        curr_timestamp = global_timestamp[sampler_index];
+        global_timestamp[sampler_index] =
+            (global_timestamp[sampler_index] + 1) % occupancy_vec_size;
+        casted_replacement_data->load_timestamp =
+            global_timestamp[sampler_index];
+
+        optgen_per_set[sampler_index].add_cache_access(curr_timestamp);
+
+        // Call get_decision on the sampled set's occupancy vector
+        opt_hit = optgen_per_set[sampler_index].get_decision(curr_timestamp,
+                                                             prev_timestamp);
+    }
 
-    // Call get_decision on optvector given the pkt's index occupancy vector
-    opt_hit =
-        optgen_per_set[index].get_decision(curr_timestamp, prev_timestamp);
+    if (isHWPrefetch(pkt)) {
+        stats.prefetchHits++;
+    } else {
+        stats.hits[getCore(pkt)]++;
+    }
+
+    // The first demand on a line filled by a writeback adopts it
+    if (casted_replacement_data->predictor_index == noPredictor) {
+        assignPredictor(casted_replacement_data, pkt);
+    }
 
-    cache_friendly = predictor.get_prediction(casted_replacement_data->pc);
+    cache_friendly = predictors[casted_replacement_data->predictor_index]
+        .get_prediction(casted_replacement_data->signature);
 
     // Update RRPV values
     if (!cache_friendly) {
-        rrpv[index][casted_replacement_data->getWay()] = SatCounter8(3, 7);
+        setRRPV(index)[casted_replacement_data->getWay()] = maxRRPV;
     } else {
         if (!opt_hit) {
-            for (uint8_t i = 0; i < num_ways; i++) {
-                if (rrpv[index][i] < 6) {
-                    rrpv[index][i]++;
-                }
-            }
+            ageSet(index);
         }
-        rrpv[index][casted_replacement_data->getWay()] = SatCounter8(3, 0);
+        setRRPV(index)[casted_replacement_data->getWay()] = 0;
     }
 }
 
@@ -145,118 +289,101 @@ void
 Hawkeye::reset(const std::shared_ptr<ReplacementData> &replacement_data,
                const PacketPtr pkt)
 {
-    // set replacement_data set,way
-    uint32_t way;
     uint32_t index;
     uint8_t cache_friendly;
 
     auto casted_replacement_data =
-        std::static_pointer_cast<HawkeyeReplData>(replacement_data);
+        static_cast<HawkeyeReplData*>(replacement_data.get());
 
-    index = (pkt->getAddr() >> floorLog2(cache_line_size)) & (num_sets - 1);
-
-    // std::cout << "Set " << casted_replacement_data->getSet() << ":";
-    // for (auto i = 0; i < num_ways; i++) {
-    //     std::cout << " " << free_ways[index][i];
-    // }
-    // std::cout << std::endl;
+    index = casted_replacement_data->getSet();
 
-    for (way = 0; way < num_ways; way++) {
-        if (free_ways[index][way]) {
-            free_ways[index][way] = false;
-            break;
+    // Writebacks are inserted with a distant RRPV, without asking or
+    // training any predictor, and are not seen by OPTgen
+    if (pkt->isWriteback()) {
+        stats.writebackMisses++;
+        casted_replacement_data->predictor_index = noPredictor;
+        casted_replacement_data->signature = 0;
+        if (isSampled(index)) {
+            casted_replacement_data->load_timestamp =
+                global_timestamp[samplerIndex(index)];
         }
+        setRRPV(index)[casted_replacement_data->getWay()] = maxRRPV;
+        return;
     }
 
-    if (way == num_ways) {
-        std::cout << "ERROR: No free ways? Assigning way = 0" << std::endl;
-        way = 0;
-        free_ways[index][way] = false;
+    if (isSampled(index)) {
+        const uint32_t sampler_index = samplerIndex(index);
+        optgen_per_set[sampler_index].add_cache_access(
+            global_timestamp[sampler_index]);
+        global_timestamp[sampler_index] =
+            (global_timestamp[sampler_index] + 1) % occupancy_vec_size;
+        casted_replacement_data->load_timestamp =
+            global_timestamp[sampler_index];
+
+        optgen_per_set[sampler_index].add_cache_access(
+            global_timestamp[sampler_index]);
     }
 
-    casted_replacement_data->set = index;
-    casted_replacement_data->way = way;
-    // std::cout << "RESET Assigning Set " << index << " Way " << way <<
-    // std::endl;
-
-    optgen_per_set[index].add_cache_access(global_timestamp[index]);
-    global_timestamp[index] =
-        (global_timestamp[index] + 1) % occupancy_vec_size;
-    casted_replacement_data->load_timestamp = global_timestamp[index];
-
-    optgen_per_set[index].add_cache_access(global_timestamp[index]);
-
-    if (pkt->req->hasPC())
-        casted_replacement_data->pc = pkt->req->getPC();
-    else
-        casted_replacement_data->pc = 0;
+    if (isHWPrefetch(pkt)) {
+        stats.prefetchMisses++;
+    } else {
+        stats.misses[getCore(pkt)]++;
+    }
 
-    cache_friendly = predictor.get_prediction(casted_replacement_data->pc);
+    assignPredictor(casted_replacement_data, pkt);
+    cache_friendly = predictors[casted_replacement_data->predictor_index]
+        .get_prediction(casted_replacement_data->signature);
 
     if (!cache_friendly) {
-        rrpv[index][casted_replacement_data->getWay()] = SatCounter8(3, 7);
+        setRRPV(index)[casted_replacement_data->getWay()] = maxRRPV;
     } else {
-        for (int i = 0; i < num_ways; i++) {
-            if ((uint8_t)rrpv[index][i] < 6) {
-                rrpv[index][i]++;
-            }
-        }
-        rrpv[index][casted_replacement_data->getWay()] = SatCounter8(3, 0);
+        ageSet(index);
+        setRRPV(index)[casted_replacement_data->getWay()] = 0;
     }
 }
 
 ReplaceableEntry *
 Hawkeye::getVictim(const ReplacementCandidates &candidates) const
 {
-    int evicted_rrpv;
-    uint32_t evicted_way;
-
-    auto repl_data_init = std::static_pointer_cast<HawkeyeReplData>(
-        candidates[0]->replacementData);
-
-    for (evicted_rrpv = 7; evicted_rrpv >= 0; evicted_rrpv--) {
-        for (evicted_way = 0; evicted_way < candidates.size(); evicted_way++) {
-            auto repl_data = std::static_pointer_cast<HawkeyeReplData>(
-                candidates[evicted_way]->replacementData);
-            assert(repl_data != nullptr);
-            assert(repl_data->getSet() < num_sets);
-            assert(repl_data->getWay() < num_ways ||
-                   !(std::cerr << "Num ways: " << num_ways << "repl_data way: "
-                               << repl_data->getWay() << std::endl));
-            assert(rrpv.size() == num_sets);
-            assert(rrpv[repl_data->getSet()].size() == num_ways);
-            if ((int)rrpv[repl_data->getSet()][repl_data->getWay()] ==
-                evicted_rrpv) {
-                free_ways[repl_data->getSet()][evicted_way] = true;
-                rrpv[repl_data->getSet()][evicted_way].saturate();
-
-                // Update predictor
-                if (evicted_rrpv == 7) {
-                    predictor.train(repl_data->pc);
-                } else {
-                    predictor.detrain(repl_data->pc);
-                }
-
-                // return evcited candidates
-                return candidates[evicted_way];
-            }
-        }
+    const uint32_t num_candidates = candidates.size();
+    assert(num_candidates > 0 && num_candidates <= maxWays);
+
+    // Gather the candidates' RRPVs in candidate order. Candidates may come
+    // from different sets, e.g., with skewed indexing policies
+    uint8_t candidate_rrpv[maxWays];
+    for (uint32_t i = 0; i < num_candidates; i++) {
+        const auto repl_data = static_cast<HawkeyeReplData *>(
+            candidates[i]->replacementData.get());
+        assert(repl_data->getSet() < num_sets);
+        assert(repl_data->getWay() < num_ways);
+        candidate_rrpv[i] = setRRPV(repl_data->getSet())[repl_data->getWay()];
     }
 
-    std::cout << "ERROR: Loop somehow didn't return anything" << std::endl;
-    return candidates[0];
-
-    auto repl_data = std::static_pointer_cast<HawkeyeReplData>(
-        candidates[evicted_way]->replacementData);
-
-    free_ways[repl_data->getSet()][evicted_way] = true;
-    rrpv[repl_data->getSet()][evicted_way].saturate();
+    // The victim is the first candidate with the highest RRPV. Finding the
+    // maximum is a vectorizable reduction; the search for its first
+    // occurrence is then guaranteed to succeed
+    uint8_t evicted_rrpv = 0;
+    for (uint32_t i = 0; i < num_candidates; i++) {
+        evicted_rrpv = std::max(evicted_rrpv, candidate_rrpv[i]);
+    }
+    uint32_t evicted_way = 0;
+    while (candidate_rrpv[evicted_way] != evicted_rrpv) {
+        evicted_way++;
+    }
 
-    // Update predictor
-    if (evicted_rrpv == 7) {
-        predictor.train(repl_data->pc);
-    } else {
-        predictor.detrain(repl_data->pc);
+    const auto repl_data = static_cast<HawkeyeReplData *>(
+        candidates[evicted_way]->replacementData.get());
+    setRRPV(repl_data->getSet())[repl_data->getWay()] = maxRRPV;
+
+    // Update predictor; only sampled sets train it
+    if (isSampled(repl_data->getSet()) &&
+        repl_data->predictor_index != noPredictor) {
+        Predictor &predictor = predictors[repl_data->predictor_index];
+        if (evicted_rrpv == maxRRPV) {
+            predictor.train(repl_data->signature);
+        } else {
+            predictor.detrain(repl_data->signature);
+        }
     }
 
     // return evcited candidates
@@ -266,7 +393,98 @@ Hawkeye::getVictim(const ReplacementCandidates &candidates) const
 std::shared_ptr<ReplacementData>
 Hawkeye::instantiateEntry()
 {
-    return std::make_shared<HawkeyeReplData>();
+    panic("Cant instantiate Hawkeye entries without their position.");
+}
+
+std::shared_ptr<ReplacementData>
+Hawkeye::instantiateEntry(const uint32_t set, const uint32_t way)
+{
+    panic_if(!rrpv.empty(),
+             "Hawkeye entries must be instantiated before initialization.");
+
+    num_sets = std::max(num_sets, set + 1);
+    num_ways = std::max(num_ways, way + 1);
+    return replDataPool.allocate(set, way);
+}
+
+void
+Hawkeye::serialize(CheckpointOut &cp) const
+{
+    SERIALIZE_SCALAR(num_sets);
+    SERIALIZE_SCALAR(num_ways);
+    SERIALIZE_CONTAINER(global_timestamp);
+
+    for (uint32_t i = 0; i < optgen_per_set.size(); i++) {
+        optgen_per_set[i].serializeSection(cp, csprintf("optgen%d", i));
+    }
+    for (uint32_t i = 0; i < predictors.size(); i++) {
+        predictors[i].serializeSection(cp, csprintf("predictor%d", i));
+    }
+}
+
+void
+Hawkeye::unserialize(CheckpointIn &cp)
+{
+    uint32_t cpt_num_sets;
+    uint32_t cpt_num_ways;
+    paramIn(cp, "num_sets", cpt_num_sets);
+    paramIn(cp, "num_ways", cpt_num_ways);
+    fatal_if(cpt_num_sets != num_sets || cpt_num_ways != num_ways,
+             "Checkpointed Hawkeye manages %dx%d entries, but %dx%d are "
+             "configured", cpt_num_sets, cpt_num_ways, num_sets, num_ways);
+
+    // The tags are not restored, so every way starts invalid and with
+    // the RRPV of an entry that is to be evicted first.
+    std::fill(rrpv.begin(), rrpv.end(), maxRRPV);
+
+    UNSERIALIZE_CONTAINER(global_timestamp);
+    fatal_if(global_timestamp.size() != optgen_per_set.size(),
+             "Checkpointed Hawkeye samples %d sets, but %d are configured",
+             global_timestamp.size(), optgen_per_set.size());
+    for (const auto timestamp : global_timestamp) {
+        fatal_if(timestamp >= occupancy_vec_size,
+                 "Checkpointed Hawkeye timestamp %d is out of range",
+                 timestamp);
+    }
+
+    for (uint32_t i = 0; i < optgen_per_set.size(); i++) {
+        optgen_per_set[i].unserializeSection(cp, csprintf("optgen%d", i));
+    }
+    for (uint32_t i = 0; i < predictors.size(); i++) {
+        predictors[i].unserializeSection(cp, csprintf("predictor%d", i));
+    }
+}
+
+Hawkeye::HawkeyeStats::HawkeyeStats(Hawkeye &parent)
+  : statistics::Group(&parent), hawkeye(parent),
+    ADD_STAT(hits, "Number of demand hits per core"),
+    ADD_STAT(misses, "Number of demand fills per core"),
+    ADD_STAT(prefetchHits, "Number of hardware prefetch hits"),
+    ADD_STAT(prefetchMisses, "Number of hardware prefetch fills"),
+    ADD_STAT(writebackHits, "Number of writeback hits"),
+    ADD_STAT(writebackMisses, "Number of writeback fills")
+{
+}
+
+void
+Hawkeye::HawkeyeStats::regStats()
+{
+    using namespace statistics;
+
+    statistics::Group::regStats();
+
+    hits
+        .init(hawkeye.num_cores)
+        .flags(total | nozero | nonan)
+        ;
+    misses
+        .init(hawkeye.num_cores)
+        .flags(total | nozero | nonan)
+        ;
+    for (uint32_t i = 0; i < hawkeye.num_cores; i++) {
+        hits.subname(i, csprintf("core%d", i));
+        misses.subname(i, csprintf("core%d", i));
+    }
 }
 
 } // namespace replacement_policy
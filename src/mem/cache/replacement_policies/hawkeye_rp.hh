@@ -1,10 +1,10 @@
 #ifndef __MEM_CACHE_REPLACEMENT_POLICIES_HAWKEYE_RP_HH__
 #define __MEM_CACHE_REPLACEMENT_POLICIES_HAWKEYE_RP_HH__
 
-#include <unordered_map>
 #include <vector>
 
-#include "base/sat_counter.hh"
+#include "base/statistics.hh"
+#include "enums/HawkeyeSHCTHash.hh"
 #include "mem/cache/replacement_policies/base.hh"
 #include "mem/cache/replacement_policies/optgen.hh"
 #include "mem/packet.hh"
@@ -24,12 +24,22 @@ class Hawkeye : public Base
   protected:
     struct HawkeyeReplData : ReplacementData
     {
-        uint64_t pc;
+        /** SHCT entry of the PC that inserted this entry. */
+        uint32_t signature;
+        /**
+         * Predictor that made the insertion decision of this entry, or
+         * noPredictor if it was inserted by a writeback.
+         */
+        uint32_t predictor_index;
         uint32_t load_timestamp;
-        uint32_t set;
-        uint32_t way;
+        /** Position of the entry in the tags. */
+        const uint32_t set;
+        const uint32_t way;
 
-        HawkeyeReplData() : pc(0), load_timestamp(0), set(0), way(0) {}
+        HawkeyeReplData(uint32_t _set, uint32_t _way)
+            : signature(0), predictor_index(0), load_timestamp(0),
+              set(_set), way(_way)
+        {}
 
         uint32_t
         getSet() const
@@ -44,41 +54,222 @@ class Hawkeye : public Base
         }
     };
 
-    class Predictor
+    /**
+     * Signature History Counter Table. A fixed number of saturating
+     * counters indexed by a hash of the PC, so unrelated PCs may alias as
+     * they would in hardware.
+     */
+    class Predictor : public Serializable
     {
-        uint32_t max_shct;
+        /** Counters are packed in host cache line sized blocks. */
+        static constexpr uint32_t countersPerLine = 64;
+        struct alignas(64) CounterLine
+        {
+            uint8_t counters[countersPerLine];
+        };
+
+        uint8_t max_shct;
         uint32_t shct_size;
-        std::unordered_map<uint64_t, int8_t> predictor;
+        HawkeyeSHCTHash hash;
+        bool fold_requestor;
+        std::vector<CounterLine> shct;
+
+        uint8_t &
+        counter(uint32_t signature)
+        {
+            return shct[signature / countersPerLine]
+                .counters[signature % countersPerLine];
+        }
 
       public:
-        bool get_prediction(uint64_t pc);
-        void train(uint64_t pc);
-        void detrain(uint64_t pc);
+        /**
+         * Get the SHCT entry used by an access.
+         *
+         * @param pc PC of the access.
+         * @param requestor Requestor of the access.
+         * @return Index of the SHCT counter.
+         */
+        uint32_t signature(uint64_t pc, RequestorID requestor) const;
 
-        Predictor(uint32_t _max_shct, uint32_t _shct_size)
-            : max_shct(_max_shct), shct_size(_shct_size)
-        {}
+        bool get_prediction(uint32_t signature);
+        void train(uint32_t signature);
+        void detrain(uint32_t signature);
+
+        Predictor(uint32_t _max_shct, uint32_t _shct_size,
+                  HawkeyeSHCTHash _hash, bool _fold_requestor);
+
+        void serialize(CheckpointOut &cp) const override;
+        void unserialize(CheckpointIn &cp) override;
     };
 
-    mutable Predictor predictor;
+    /** Number of cores that have a private predictor. */
+    const uint32_t num_cores;
 
-    mutable std::vector<std::vector<SatCounter8>> rrpv;
-    mutable std::vector<std::vector<bool>> free_ways;
+    /** Whether hardware prefetches have their own predictor. */
+    const bool prefetch_predictor;
 
+    /**
+     * One predictor per core, followed by the prefetch predictor when
+     * prefetches are trained separately.
+     */
+    mutable std::vector<Predictor> predictors;
+
+    /** Predictor index of the entries that no predictor decided on. */
+    static constexpr uint32_t noPredictor = UINT32_MAX;
+
+    /**
+     * Whether an access is a hardware prefetch. Below the first cache
+     * level the prefetches of the upper caches are plain reads, so this
+     * also looks at the task of their request.
+     *
+     * @param pkt The access.
+     * @return Whether the access was generated by a prefetcher.
+     */
+    static bool isHWPrefetch(const PacketPtr pkt);
+
+    /**
+     * Make the predictor of an access responsible for an entry.
+     *
+     * @param repl_data Replacement data of the entry.
+     * @param pkt The access.
+     */
+    void assignPredictor(HawkeyeReplData *repl_data, const PacketPtr pkt);
+
+    /**
+     * Get the core that generated an access. Demand accesses that are not
+     * associated to a thread context are attributed to core 0, and so is
+     * every access when there is a single core. Otherwise the context ID
+     * is the core, and must be below the number of cores.
+     *
+     * @param pkt The access.
+     * @return The core of the access.
+     */
+    uint32_t getCore(const PacketPtr pkt) const;
+
+    /**
+     * Get the predictor that makes the decisions of an access.
+     *
+     * @param pkt The access.
+     * @return Index into predictors.
+     */
+    uint32_t getPredictorIndex(const PacketPtr pkt) const;
+
+    /** Hawkeye's RRPVs are 3 bits wide. */
+    static constexpr uint8_t maxRRPV = 7;
+
+    /** Maximum supported number of victim candidates. */
+    static constexpr uint32_t maxWays = 64;
+
+    /**
+     * RRPVs of all entries, packed contiguously set by set, so that a set
+     * can be aged and searched as one small array.
+     */
+    mutable std::vector<uint8_t> rrpv;
+
+    /** One OPTgen and timestamp per sampled set. */
     std::vector<OPTgen> optgen_per_set;
 
     std::vector<uint32_t> global_timestamp;
 
+    /**
+     * Geometry of the tags, learnt from the positions of the entries as
+     * they are instantiated.
+     */
     uint32_t num_sets;
     uint32_t num_ways;
-    int cache_line_size;
+
     uint32_t occupancy_vec_size;
+    uint32_t sampled_sets;
+    OPTgenBackend optgen_backend;
+
+    /**
+     * Get the RRPVs of a set.
+     *
+     * @param set The set.
+     * @return Pointer to the num_ways RRPVs of the set.
+     */
+    uint8_t *
+    setRRPV(uint32_t set) const
+    {
+        return &rrpv[set * num_ways];
+    }
+
+    /**
+     * Age every entry of a set that is not yet predicted to be evicted.
+     *
+     * @param set The set to age.
+     */
+    void ageSet(uint32_t set) const;
+
+    /** Every sampler_stride-th set is sampled. */
+    uint32_t sampler_stride;
+
+    /**
+     * Whether a set runs OPTgen and trains the predictor.
+     *
+     * @param set The set to check.
+     * @return True if the set is sampled.
+     */
+    bool
+    isSampled(uint32_t set) const
+    {
+        return set % sampler_stride == 0;
+    }
+
+    /**
+     * Get the OPTgen/timestamp slot of a sampled set.
+     *
+     * @param set A sampled set.
+     * @return Index into optgen_per_set and global_timestamp.
+     */
+    uint32_t
+    samplerIndex(uint32_t set) const
+    {
+        return set / sampler_stride;
+    }
+
+    struct HawkeyeStats : public statistics::Group
+    {
+        HawkeyeStats(Hawkeye &parent);
+
+        void regStats() override;
+
+        const Hawkeye &hawkeye;
+
+        /** Number of demand hits per core. */
+        statistics::Vector hits;
+
+        /** Number of demand fills per core. */
+        statistics::Vector misses;
+
+        /** Number of hardware prefetch hits. */
+        statistics::Scalar prefetchHits;
+
+        /** Number of hardware prefetch fills. */
+        statistics::Scalar prefetchMisses;
+
+        /** Number of writeback hits. */
+        statistics::Scalar writebackHits;
+
+        /** Number of writeback fills. */
+        statistics::Scalar writebackMisses;
+    } stats;
+
+  private:
+    /** Storage of the replacement data of the entries. */
+    ReplacementDataPool<HawkeyeReplData> replDataPool;
 
   public:
     typedef HawkeyeRPParams Params;
     Hawkeye(const Params &p);
     ~Hawkeye() = default;
 
+    /**
+     * Allocate the per-set state once all entries have been instantiated
+     * and the geometry of the tags is known.
+     */
+    void init() override;
+
     /**
      *
      * @param replacement_data Replacement data to be invalidated.
@@ -116,12 +307,31 @@ class Hawkeye : public Base
     ReplaceableEntry *
     getVictim(const ReplacementCandidates &candidates) const override;
 
+    /** Hawkeye trains its predictors on the PC and core of each access. */
+    bool needsPacket() const override { return true; }
+
+    /**
+     * Hawkeye cannot instantiate an entry without knowing its position.
+     */
+    std::shared_ptr<ReplacementData> instantiateEntry() override;
+
     /**
      * Instantiate a replacement data entry.
      *
+     * @param set The set of the entry.
+     * @param way The way of the entry.
      * @return A shared pointer to the new replacement data.
      */
-    std::shared_ptr<ReplacementData> instantiateEntry() override;
+    std::shared_ptr<ReplacementData> instantiateEntry(const uint32_t set,
+        const uint32_t way) override;
+
+    /**
+     * Checkpoint the learnt state: the predictors and OPTgen. The RRPVs
+     * and per-entry signatures are not saved, as the tags themselves are
+     * not restored, and the RRPVs are reset on restore instead.
+     */
+    void serialize(CheckpointOut &cp) const override;
+    void unserialize(CheckpointIn &cp) override;
 };
 
 } // namespace replacement_policy
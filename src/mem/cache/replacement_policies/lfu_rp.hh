@@ -63,6 +63,10 @@ class LFU : public Base
         LFUReplData() : refCount(0) {}
     };
 
+  private:
+    /** Storage of the replacement data of the entries. */
+    ReplacementDataPool<LFUReplData> replDataPool;
+
   public:
     typedef LFURPParams Params;
     LFU(const Params &p);
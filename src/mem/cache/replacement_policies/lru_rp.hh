@@ -61,6 +61,10 @@ class LRU : public Base
         LRUReplData() : lastTouchTick(0) {}
     };
 
+  private:
+    /** Storage of the replacement data of the entries. */
+    ReplacementDataPool<LRUReplData> replDataPool;
+
   public:
     typedef LRURPParams Params;
     LRU(const Params &p);
@@ -50,24 +50,24 @@ void
 MRU::invalidate(const std::shared_ptr<ReplacementData>& replacement_data)
 {
     // Reset last touch timestamp
-    std::static_pointer_cast<MRUReplData>(
-        replacement_data)->lastTouchTick = Tick(0);
+    static_cast<MRUReplData*>(
+        replacement_data.get())->lastTouchTick = Tick(0);
 }
 
 void
 MRU::touch(const std::shared_ptr<ReplacementData>& replacement_data) const
 {
     // Update last touch timestamp
-    std::static_pointer_cast<MRUReplData>(
-        replacement_data)->lastTouchTick = curTick();
+    static_cast<MRUReplData*>(
+        replacement_data.get())->lastTouchTick = curTick();
 }
 
 void
 MRU::reset(const std::shared_ptr<ReplacementData>& replacement_data) const
 {
     // Set last touch timestamp
-    std::static_pointer_cast<MRUReplData>(
-        replacement_data)->lastTouchTick = curTick();
+    static_cast<MRUReplData*>(
+        replacement_data.get())->lastTouchTick = curTick();
 }
 
 ReplaceableEntry*
@@ -79,16 +79,16 @@ MRU::getVictim(const ReplacementCandidates& candidates) const
     // Visit all candidates to find victim
     ReplaceableEntry* victim = candidates[0];
     for (const auto& candidate : candidates) {
-        std::shared_ptr<MRUReplData> candidate_replacement_data =
-            std::static_pointer_cast<MRUReplData>(candidate->replacementData);
+        MRUReplData* candidate_replacement_data =
+            static_cast<MRUReplData*>(candidate->replacementData.get());
 
         // Stop searching entry if a cache line that doesn't warm up is found.
         if (candidate_replacement_data->lastTouchTick == 0) {
             victim = candidate;
             break;
         } else if (candidate_replacement_data->lastTouchTick >
-                std::static_pointer_cast<MRUReplData>(
-                    victim->replacementData)->lastTouchTick) {
+                static_cast<MRUReplData*>(
+                    victim->replacementData.get())->lastTouchTick) {
             victim = candidate;
         }
     }
@@ -99,7 +99,7 @@ MRU::getVictim(const ReplacementCandidates& candidates) const
 std::shared_ptr<ReplacementData>
 MRU::instantiateEntry()
 {
-    return std::shared_ptr<ReplacementData>(new MRUReplData());
+    return replDataPool.allocate();
 }
 
 } // namespace replacement_policy
@@ -63,6 +63,10 @@ class MRU : public Base
         MRUReplData() : lastTouchTick(0) {}
     };
 
+  private:
+    /** Storage of the replacement data of the entries. */
+    ReplacementDataPool<MRUReplData> replDataPool;
+
   public:
     typedef MRURPParams Params;
     MRU(const Params &p);
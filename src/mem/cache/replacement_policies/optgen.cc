@@ -1,24 +1,171 @@
 #include "mem/cache/replacement_policies/optgen.hh"
 
+#include <algorithm>
 #include <cstdint>
 
+#include "base/logging.hh"
+
 namespace gem5 {
 
 GEM5_DEPRECATED_NAMESPACE(ReplacementPolicy, replacement_policy);
 namespace replacement_policy {
 
-OPTgen::OPTgen(uint32_t _cache_capacity, int occupancy_vec_size)
+OPTgen::OPTgen(uint32_t _cache_capacity, int occupancy_vec_size,
+               OPTgenBackend _backend)
     : cache_capacity(_cache_capacity), num_access(0), num_hits(0),
-      num_misses(0), occupancy_vec(occupancy_vec_size, 0) {}
+      num_misses(0), backend(_backend), num_leaves(occupancy_vec_size) {
+  if (backend == OPTgenBackend::segment_tree) {
+    tree_max.resize(4 * num_leaves, 0);
+    tree_lazy.resize(4 * num_leaves, 0);
+  } else {
+    occupancy_vec.resize(occupancy_vec_size, 0);
+  }
+}
+
+void OPTgen::tree_push(uint32_t node) {
+  if (tree_lazy[node]) {
+    for (uint32_t child = 2 * node; child <= 2 * node + 1; child++) {
+      tree_max[child] += tree_lazy[node];
+      tree_lazy[child] += tree_lazy[node];
+    }
+    tree_lazy[node] = 0;
+  }
+}
+
+void OPTgen::tree_set(uint32_t node, uint32_t lo, uint32_t hi, uint32_t pos,
+                      unsigned int value) {
+  if (lo == hi) {
+    tree_max[node] = value;
+    return;
+  }
+
+  tree_push(node);
+  const uint32_t mid = (lo + hi) / 2;
+  if (pos <= mid) {
+    tree_set(2 * node, lo, mid, pos, value);
+  } else {
+    tree_set(2 * node + 1, mid + 1, hi, pos, value);
+  }
+  tree_max[node] = std::max(tree_max[2 * node], tree_max[2 * node + 1]);
+}
+
+unsigned int OPTgen::tree_query(uint32_t node, uint32_t lo, uint32_t hi,
+                                uint32_t begin, uint32_t end) {
+  if (begin <= lo && hi <= end) {
+    return tree_max[node];
+  }
+
+  tree_push(node);
+  const uint32_t mid = (lo + hi) / 2;
+  unsigned int result = 0;
+  if (begin <= mid) {
+    result = tree_query(2 * node, lo, mid, begin, end);
+  }
+  if (end > mid) {
+    result = std::max(result, tree_query(2 * node + 1, mid + 1, hi, begin,
+                                         end));
+  }
+  return result;
+}
+
+void OPTgen::tree_increment(uint32_t node, uint32_t lo, uint32_t hi,
+                            uint32_t begin, uint32_t end) {
+  if (begin <= lo && hi <= end) {
+    tree_max[node]++;
+    tree_lazy[node]++;
+    return;
+  }
+
+  tree_push(node);
+  const uint32_t mid = (lo + hi) / 2;
+  if (begin <= mid) {
+    tree_increment(2 * node, lo, mid, begin, end);
+  }
+  if (end > mid) {
+    tree_increment(2 * node + 1, mid + 1, hi, begin, end);
+  }
+  tree_max[node] = std::max(tree_max[2 * node], tree_max[2 * node + 1]);
+}
+
+unsigned int OPTgen::range_max(uint32_t begin, uint32_t end) {
+  // The tree works on inclusive, non-wrapping ranges, so split the
+  // circular range at the end of the vector
+  if (begin < end) {
+    return tree_query(1, 0, num_leaves - 1, begin, end - 1);
+  }
+
+  unsigned int result = tree_query(1, 0, num_leaves - 1, begin,
+                                   num_leaves - 1);
+  if (end > 0) {
+    result = std::max(result, tree_query(1, 0, num_leaves - 1, 0, end - 1));
+  }
+  return result;
+}
+
+void OPTgen::range_increment(uint32_t begin, uint32_t end) {
+  if (begin < end) {
+    tree_increment(1, 0, num_leaves - 1, begin, end - 1);
+    return;
+  }
+
+  tree_increment(1, 0, num_leaves - 1, begin, num_leaves - 1);
+  if (end > 0) {
+    tree_increment(1, 0, num_leaves - 1, 0, end - 1);
+  }
+}
+
+unsigned int OPTgen::occupancy(uint32_t timestamp) const {
+  if (backend != OPTgenBackend::segment_tree) {
+    return occupancy_vec[timestamp];
+  }
+
+  // Walk down to the leaf, adding the increments that have not been
+  // pushed down yet
+  uint32_t node = 1;
+  uint32_t lo = 0;
+  uint32_t hi = num_leaves - 1;
+  unsigned int pending = 0;
+  while (lo != hi) {
+    pending += tree_lazy[node];
+    const uint32_t mid = (lo + hi) / 2;
+    if (timestamp <= mid) {
+      node = 2 * node;
+      hi = mid;
+    } else {
+      node = 2 * node + 1;
+      lo = mid + 1;
+    }
+  }
+  return tree_max[node] + pending;
+}
 
 void OPTgen::add_cache_access(uint32_t timestamp) {
   num_access++;
-  occupancy_vec[timestamp] = 1;
+  if (backend == OPTgenBackend::segment_tree) {
+    tree_set(1, 0, num_leaves - 1, timestamp, 1);
+  } else {
+    occupancy_vec[timestamp] = 1;
+  }
 }
 
 bool OPTgen::get_decision(uint32_t curr_timestamp, uint32_t prev_timestamp) {
   bool is_hit = true;
 
+  if (backend == OPTgenBackend::segment_tree) {
+    if (prev_timestamp == curr_timestamp) {
+      return is_hit;
+    }
+
+    if (range_max(prev_timestamp, curr_timestamp) >= cache_capacity) {
+      is_hit = false;
+      num_misses++;
+    } else {
+      range_increment(prev_timestamp, curr_timestamp);
+    }
+
+    return is_hit;
+  }
+
   for (uint32_t i = prev_timestamp; i != curr_timestamp;
        i = (i + 1) % occupancy_vec.size()) {
     if (occupancy_vec[i] >= cache_capacity) {
@@ -39,5 +186,39 @@ bool OPTgen::get_decision(uint32_t curr_timestamp, uint32_t prev_timestamp) {
   return is_hit;
 }
 
+void OPTgen::serialize(CheckpointOut &cp) const {
+  SERIALIZE_SCALAR(num_access);
+  SERIALIZE_SCALAR(num_hits);
+  SERIALIZE_SCALAR(num_misses);
+
+  std::vector<unsigned int> occupancies(num_leaves);
+  for (uint32_t i = 0; i < num_leaves; i++) {
+    occupancies[i] = occupancy(i);
+  }
+  arrayParamOut(cp, "occupancy_vec", occupancies);
+}
+
+void OPTgen::unserialize(CheckpointIn &cp) {
+  UNSERIALIZE_SCALAR(num_access);
+  UNSERIALIZE_SCALAR(num_hits);
+  UNSERIALIZE_SCALAR(num_misses);
+
+  std::vector<unsigned int> occupancies;
+  arrayParamIn(cp, "occupancy_vec", occupancies);
+  fatal_if(occupancies.size() != num_leaves,
+           "Checkpointed OPTgen has %d timestamps, but %d are configured.",
+           occupancies.size(), num_leaves);
+
+  if (backend == OPTgenBackend::segment_tree) {
+    std::fill(tree_max.begin(), tree_max.end(), 0);
+    std::fill(tree_lazy.begin(), tree_lazy.end(), 0);
+    for (uint32_t i = 0; i < num_leaves; i++) {
+      tree_set(1, 0, num_leaves - 1, i, occupancies[i]);
+    }
+  } else {
+    occupancy_vec = occupancies;
+  }
+}
+
 } // namespace replacement_policy
 } // namespace gem5
@@ -4,27 +4,65 @@
 #include <cstdint>
 #include <vector>
 
-#include "mem/cache/replacement_policies/base.hh"
+#include "base/compiler.hh"
+#include "enums/OPTgenBackend.hh"
+#include "sim/serialize.hh"
 
 namespace gem5 {
 
 GEM5_DEPRECATED_NAMESPACE(ReplacementPolicy, replacement_policy);
 namespace replacement_policy {
 
-class OPTgen
+class OPTgen : public Serializable
 {
   uint32_t cache_capacity;
   uint32_t num_access;
   uint32_t num_hits;
   uint32_t num_misses;
 
+  OPTgenBackend backend;
+
+  /** Occupancy of every timestamp, used by the linear backend. */
   std::vector<unsigned int> occupancy_vec;
 
+  /**
+   * Max-segment-tree over the occupancy vector with lazy range increments,
+   * used by the segment tree backend. Node 1 is the root and node i has
+   * children 2i and 2i+1.
+   */
+  uint32_t num_leaves;
+  std::vector<unsigned int> tree_max;
+  std::vector<unsigned int> tree_lazy;
+
+  void tree_push(uint32_t node);
+  void tree_set(uint32_t node, uint32_t lo, uint32_t hi, uint32_t pos,
+                unsigned int value);
+  unsigned int tree_query(uint32_t node, uint32_t lo, uint32_t hi,
+                          uint32_t begin, uint32_t end);
+  void tree_increment(uint32_t node, uint32_t lo, uint32_t hi,
+                      uint32_t begin, uint32_t end);
+
+  /** Max occupancy over the circular range [begin, end). */
+  unsigned int range_max(uint32_t begin, uint32_t end);
+  /** Increment the occupancy over the circular range [begin, end). */
+  void range_increment(uint32_t begin, uint32_t end);
+
+  /** Occupancy of a single timestamp, whatever the backend. */
+  unsigned int occupancy(uint32_t timestamp) const;
+
 public:
-  OPTgen(uint32_t _cache_size, int occupancy_vec_size);
+  OPTgen(uint32_t _cache_size, int occupancy_vec_size,
+         OPTgenBackend _backend = OPTgenBackend::linear);
 
   void add_cache_access(uint32_t timestamp);
   bool get_decision(uint32_t curr_timestamp, uint32_t prev_timestamp);
+
+  /**
+   * The occupancy vector is checkpointed timestamp by timestamp, so a
+   * checkpoint can be restored with either backend.
+   */
+  void serialize(CheckpointOut &cp) const override;
+  void unserialize(CheckpointIn &cp) override;
 };
 
 } // namespace replacement_policy
@@ -0,0 +1,136 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <random>
+#include <sstream>
+
+#include "base/gtest/serialization_fixture.hh"
+#include "mem/cache/replacement_policies/optgen.hh"
+
+using namespace gem5;
+
+/**
+ * Drive both OPTgen backends with the same sequence of accesses, in the
+ * way Hawkeye does, and make sure they always take the same decision.
+ */
+static void
+checkSameDecisions(replacement_policy::OPTgen &linear,
+                   replacement_policy::OPTgen &tree, uint32_t vec_size,
+                   int num_accesses, uint32_t timestamp = 0)
+{
+    std::mt19937 gen(0x5eed + timestamp);
+    std::uniform_int_distribution<uint32_t> dist(0, vec_size - 1);
+
+    for (int i = 0; i < num_accesses; i++) {
+        // Reuse a recent timestamp most of the time, to make hits likely
+        const uint32_t distance = dist(gen) % ((i % 4) ? 8 : vec_size);
+        const uint32_t prev_timestamp =
+            (timestamp + vec_size - distance) % vec_size;
+
+        linear.add_cache_access(timestamp);
+        tree.add_cache_access(timestamp);
+        ASSERT_EQ(linear.get_decision(timestamp, prev_timestamp),
+                  tree.get_decision(timestamp, prev_timestamp))
+            << "access " << i << " timestamp " << timestamp
+            << " prev_timestamp " << prev_timestamp;
+
+        timestamp = (timestamp + 1) % vec_size;
+    }
+}
+
+static void
+checkSameDecisions(uint32_t capacity, uint32_t vec_size, int num_accesses)
+{
+    replacement_policy::OPTgen linear(capacity, vec_size,
+                                      OPTgenBackend::linear);
+    replacement_policy::OPTgen tree(capacity, vec_size,
+                                    OPTgenBackend::segment_tree);
+    checkSameDecisions(linear, tree, vec_size, num_accesses);
+}
+
+/** Check that the backends agree for the default Hawkeye geometry. */
+TEST(OPTgenTest, SegmentTreeMatchesLinear)
+{
+    checkSameDecisions(16, 128, 100000);
+}
+
+/** Check that the backends agree with a long, non-power-of-two history. */
+TEST(OPTgenTest, SegmentTreeMatchesLinearLongHistory)
+{
+    checkSameDecisions(20, 160, 100000);
+}
+
+/** Check that the backends agree when the capacity is hit often. */
+TEST(OPTgenTest, SegmentTreeMatchesLinearSmallCapacity)
+{
+    checkSameDecisions(2, 64, 100000);
+}
+
+/** An empty reuse interval is always an OPT hit. */
+TEST(OPTgenTest, EmptyInterval)
+{
+    replacement_policy::OPTgen tree(1, 16, OPTgenBackend::segment_tree);
+    tree.add_cache_access(3);
+    ASSERT_TRUE(tree.get_decision(3, 3));
+}
+
+using OPTgenSerializationFixture = SerializationFixture;
+
+/**
+ * A checkpoint taken with one backend can be restored with the other, and
+ * both go on taking the same decisions.
+ */
+TEST_F(OPTgenSerializationFixture, RestoreWithOtherBackend)
+{
+    const uint32_t vec_size = 128;
+    replacement_policy::OPTgen linear(16, vec_size, OPTgenBackend::linear);
+    replacement_policy::OPTgen tree(16, vec_size,
+                                    OPTgenBackend::segment_tree);
+    checkSameDecisions(linear, tree, vec_size, 1000);
+
+    std::ostringstream linear_cp;
+    linear.serializeSection(linear_cp, "linear");
+    std::ostringstream tree_cp;
+    tree.serializeSection(tree_cp, "tree");
+    simulateSerialization(linear_cp.str() + tree_cp.str());
+
+    replacement_policy::OPTgen restored_tree(16, vec_size,
+                                             OPTgenBackend::segment_tree);
+    replacement_policy::OPTgen restored_linear(16, vec_size,
+                                               OPTgenBackend::linear);
+    CheckpointIn cp(getDirName());
+    restored_tree.unserializeSection(cp, "linear");
+    restored_linear.unserializeSection(cp, "tree");
+
+    // Both restored copies must carry on exactly like the originals; 1000
+    // accesses leave the timestamp at 1000 % vec_size
+    checkSameDecisions(linear, restored_tree, vec_size, 1000,
+                       1000 % vec_size);
+    checkSameDecisions(restored_linear, tree, vec_size, 1000,
+                       1000 % vec_size);
+}
@@ -64,6 +64,10 @@ class Random : public Base
         RandomReplData() : valid(false) {}
     };
 
+  private:
+    /** Storage of the replacement data of the entries. */
+    ReplacementDataPool<RandomReplData> replDataPool;
+
   public:
     typedef RandomRPParams Params;
     Random(const Params &p);
@@ -0,0 +1,431 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Host time microbenchmark of the replacement policies. Every policy
+ * manages a set associative array of tagged entries, indexed as in
+ * BaseSetAssoc, and is driven through the same touch, getVictim,
+ * invalidate and reset sequence that the tags perform on hits and misses.
+ * For each policy and access stream it reports the host time per access,
+ * the hit rate and the heap memory the policy allocates per block.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "base/cprintf.hh"
+#include "base/logging.hh"
+#include "config/have_protobuf.hh"
+#include "mem/cache/replacement_policies/brrip_rp.hh"
+#include "mem/cache/replacement_policies/dueling_rp.hh"
+#include "mem/cache/replacement_policies/hawkeye_rp.hh"
+#include "mem/cache/replacement_policies/lru_rp.hh"
+#include "mem/cache/replacement_policies/ship_rp.hh"
+#include "mem/cache/replacement_policies/tree_plru_rp.hh"
+#include "mem/cache/tags/indexing_policies/set_associative.hh"
+#include "mem/cache/tags/tagged_entry.hh"
+#include "mem/packet.hh"
+#include "mem/request.hh"
+#include "params/BRRIPRP.hh"
+#include "params/DuelingRP.hh"
+#include "params/HawkeyeRP.hh"
+#include "params/LRURP.hh"
+#include "params/SHiPPCRP.hh"
+#include "params/SetAssociative.hh"
+#include "params/TreePLRURP.hh"
+#include "sim/eventq.hh"
+
+#if HAVE_PROTOBUF
+#include "proto/packet.pb.h"
+#include "proto/protoio.hh"
+#endif
+
+namespace
+{
+
+/** Bytes allocated on the heap so far, used to measure policy metadata. */
+std::size_t allocatedBytes = 0;
+
+} // anonymous namespace
+
+void *
+operator new(std::size_t size)
+{
+    allocatedBytes += size;
+    if (void *ptr = std::malloc(size ? size : 1)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void *
+operator new(std::size_t size, std::align_val_t align)
+{
+    allocatedBytes += size;
+    const std::size_t alignment = static_cast<std::size_t>(align);
+    const std::size_t rounded =
+        ((size ? size : 1) + alignment - 1) / alignment * alignment;
+    if (void *ptr = std::aligned_alloc(alignment, rounded)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void *ptr) noexcept { std::free(ptr); }
+void operator delete(void *ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete(void *ptr, std::align_val_t) noexcept { std::free(ptr); }
+void
+operator delete(void *ptr, std::size_t, std::align_val_t) noexcept
+{
+    std::free(ptr);
+}
+
+namespace gem5
+{
+
+namespace
+{
+
+struct Access
+{
+    Addr addr;
+    Addr pc;
+};
+
+struct Geometry
+{
+    uint32_t numSets;
+    uint32_t numWays;
+    uint32_t blkSize;
+
+    uint64_t numBlocks() const { return uint64_t(numSets) * numWays; }
+    uint64_t size() const { return numBlocks() * blkSize; }
+};
+
+/**
+ * Fill in the parameters common to all the SimObjects of the bench. As
+ * SimObjects keep a reference to their parameters, these are never freed.
+ */
+template <class Params>
+Params &
+makeParams(const std::string &name)
+{
+    Params *params = new Params;
+    params->name = "bench." + name;
+    params->eventq_index = 0;
+    return *params;
+}
+
+replacement_policy::Base *
+makeBRRIP(const std::string &name, int btp)
+{
+    auto &params = makeParams<BRRIPRPParams>(name);
+    params.num_bits = 2;
+    params.hit_priority = false;
+    params.btp = btp;
+    return new replacement_policy::BRRIP(params);
+}
+
+struct Policy
+{
+    const char *name;
+    std::function<replacement_policy::Base *(const Geometry &)> create;
+};
+
+const std::vector<Policy> policies = {
+    {"LRU", [](const Geometry &geometry) -> replacement_policy::Base * {
+        return new replacement_policy::LRU(makeParams<LRURPParams>("lru"));
+    }},
+    {"TreePLRU", [](const Geometry &geometry) -> replacement_policy::Base * {
+        auto &params = makeParams<TreePLRURPParams>("tree_plru");
+        params.num_leaves = geometry.numWays;
+        return new replacement_policy::TreePLRU(params);
+    }},
+    {"BRRIP", [](const Geometry &geometry) {
+        return makeBRRIP("brrip", 3);
+    }},
+    {"DRRIP", [](const Geometry &geometry) -> replacement_policy::Base * {
+        // 32 dueling sets, as in the paper
+        auto &params = makeParams<DuelingRPParams>("drrip");
+        params.constituency_size =
+            std::max<uint64_t>(geometry.numBlocks() / (32 * geometry.numWays),
+                               2 * geometry.numWays);
+        params.team_size = geometry.numWays;
+        params.replacement_policy_a = makeBRRIP("drrip.brrip", 3);
+        params.replacement_policy_b = makeBRRIP("drrip.rrip", 100);
+        return new replacement_policy::Dueling(params);
+    }},
+    {"SHiPPC", [](const Geometry &geometry) -> replacement_policy::Base * {
+        auto &params = makeParams<SHiPPCRPParams>("ship_pc");
+        params.num_bits = 2;
+        params.hit_priority = true;
+        params.btp = 0;
+        params.shct_size = 16384;
+        params.insertion_threshold = 1;
+        return new replacement_policy::SHiPPC(params);
+    }},
+    {"Hawkeye", [](const Geometry &geometry) -> replacement_policy::Base * {
+        auto &params = makeParams<HawkeyeRPParams>("hawkeye");
+        params.max_rrpv = 7;
+        params.shct_size = 16384;
+        params.max_shct = 31;
+        params.shct_hash = HawkeyeSHCTHash::modulo;
+        params.shct_fold_requestor = false;
+        params.num_cores = 1;
+        params.prefetch_predictor = false;
+        params.occupancy_vec_size = 128;
+        params.optgen_backend = OPTgenBackend::linear;
+        params.sampled_sets = 0;
+        return new replacement_policy::Hawkeye(params);
+    }},
+};
+
+/** Uniformly random lines over a footprint twice the size of the cache. */
+std::vector<Access>
+randomStream(const Geometry &geometry, uint64_t num_accesses)
+{
+    std::mt19937_64 gen(0x5eed);
+    std::uniform_int_distribution<uint64_t> line(0,
+                                                 2 * geometry.numBlocks() - 1);
+    std::vector<Access> stream(num_accesses);
+    for (auto &access : stream) {
+        access = {line(gen) * geometry.blkSize, 0x400000};
+    }
+    return stream;
+}
+
+/** A cyclic scan over 1.5 times the cache, which thrashes LRU. */
+std::vector<Access>
+loopStream(const Geometry &geometry, uint64_t num_accesses)
+{
+    const uint64_t footprint = geometry.numBlocks() * 3 / 2;
+    std::vector<Access> stream(num_accesses);
+    for (uint64_t i = 0; i < num_accesses; i++) {
+        stream[i] = {(i % footprint) * geometry.blkSize, 0x400100};
+    }
+    return stream;
+}
+
+/**
+ * Random accesses to a hot working set of half the cache, interleaved
+ * with a scan that is never reused. The two come from different PCs, so
+ * PC-based policies can learn to bypass the scan.
+ */
+std::vector<Access>
+mixedStream(const Geometry &geometry, uint64_t num_accesses)
+{
+    std::mt19937_64 gen(0x5eed);
+    const uint64_t hot_lines = geometry.numBlocks() / 2;
+    std::uniform_int_distribution<uint64_t> hot(0, hot_lines - 1);
+    std::vector<Access> stream(num_accesses);
+    uint64_t scan = hot_lines;
+    for (uint64_t i = 0; i < num_accesses; i++) {
+        if (i % 4 == 3) {
+            stream[i] = {scan++ * geometry.blkSize, 0x400200};
+        } else {
+            stream[i] = {hot(gen) * geometry.blkSize, 0x400300};
+        }
+    }
+    return stream;
+}
+
+#if HAVE_PROTOBUF
+/** Read the accesses of a packet trace, e.g., from a MemTraceProbe. */
+std::vector<Access>
+traceStream(const std::string &filename, uint64_t num_accesses)
+{
+    ProtoInputStream trace(filename);
+    ProtoMessage::PacketHeader header_msg;
+    fatal_if(!trace.read(header_msg),
+             "Failed to read packet header from %s", filename);
+
+    std::vector<Access> stream;
+    ProtoMessage::Packet pkt_msg;
+    while (stream.size() < num_accesses && trace.read(pkt_msg)) {
+        stream.push_back({pkt_msg.addr(),
+                          pkt_msg.has_pc() ? pkt_msg.pc() : 0});
+    }
+    return stream;
+}
+#endif
+
+struct Result
+{
+    double nsPerAccess;
+    double hitRate;
+    double bytesPerBlock;
+};
+
+Result
+run(const Policy &policy, const Geometry &geometry,
+    const std::vector<Access> &stream)
+{
+    auto indexing_params = makeParams<SetAssociativeParams>("indexing");
+    indexing_params.size = geometry.size();
+    indexing_params.assoc = geometry.numWays;
+    indexing_params.entry_size = geometry.blkSize;
+    SetAssociative indexing(indexing_params);
+
+    std::vector<TaggedEntry> entries(geometry.numBlocks());
+
+    // Everything the policy allocates while the tags are initialized is
+    // replacement metadata
+    const std::size_t allocated_before = allocatedBytes;
+    replacement_policy::Base *rp = policy.create(geometry);
+    for (uint64_t i = 0; i < entries.size(); i++) {
+        indexing.setEntry(&entries[i], i);
+        entries[i].replacementData =
+            rp->instantiateEntry(entries[i].getSet(), entries[i].getWay());
+    }
+    rp->init();
+    const std::size_t metadata = allocatedBytes - allocated_before;
+    rp->regStats();
+
+    RequestPtr req = std::make_shared<Request>(0, geometry.blkSize, 0, 0);
+    uint64_t hits = 0;
+
+    // Every access happens one tick after the previous one, so that
+    // recency-based policies can tell them apart
+    Tick tick = curTick();
+
+    const auto start = std::chrono::steady_clock::now();
+    for (const auto &access : stream) {
+        curEventQueue()->setCurTick(++tick);
+        req->setPaddr(access.addr);
+        req->setPC(access.pc);
+        Packet pkt(req, MemCmd::ReadReq);
+
+        const Addr tag = indexing.extractTag(access.addr);
+        const auto &candidates = indexing.getPossibleEntries(access.addr);
+        TaggedEntry *blk = nullptr;
+        for (const auto candidate : candidates) {
+            auto entry = static_cast<TaggedEntry *>(candidate);
+            if (entry->matchTag(tag, false)) {
+                blk = entry;
+                break;
+            }
+        }
+
+        if (blk) {
+            hits++;
+            rp->touch(blk->replacementData, &pkt);
+        } else {
+            blk = static_cast<TaggedEntry *>(rp->getVictim(candidates));
+            if (blk->isValid()) {
+                rp->invalidate(blk->replacementData);
+                blk->invalidate();
+            }
+            blk->insert(tag, false);
+            rp->reset(blk->replacementData, &pkt);
+        }
+    }
+    const std::chrono::duration<double, std::nano> elapsed =
+        std::chrono::steady_clock::now() - start;
+
+    delete rp;
+
+    return {elapsed.count() / stream.size(),
+            double(hits) / stream.size(),
+            double(metadata) / geometry.numBlocks()};
+}
+
+void
+usage(const char *name)
+{
+    cprintf("Usage: %s [--sets N] [--ways N] [--accesses N] "
+            "[--trace FILE]\n", name);
+}
+
+} // anonymous namespace
+} // namespace gem5
+
+int
+main(int argc, char **argv)
+{
+    using namespace gem5;
+
+    // Requests and policies such as LRU read curTick()
+    curEventQueue(getEventQueue(0));
+
+    Geometry geometry{2048, 16, 64};
+    uint64_t num_accesses = 4 << 20;
+    std::string trace;
+
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        if (i + 1 == argc) {
+            usage(argv[0]);
+            return 1;
+        }
+        const std::string value = argv[++i];
+        if (arg == "--sets") {
+            geometry.numSets = std::stoul(value);
+        } else if (arg == "--ways") {
+            geometry.numWays = std::stoul(value);
+        } else if (arg == "--accesses") {
+            num_accesses = std::stoull(value);
+        } else if (arg == "--trace") {
+            trace = value;
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+
+    std::vector<std::pair<std::string, std::vector<Access>>> streams;
+    streams.emplace_back("random", randomStream(geometry, num_accesses));
+    streams.emplace_back("loop", loopStream(geometry, num_accesses));
+    streams.emplace_back("mixed", mixedStream(geometry, num_accesses));
+    if (!trace.empty()) {
+#if HAVE_PROTOBUF
+        streams.emplace_back("trace", traceStream(trace, num_accesses));
+#else
+        fatal("Reading traces requires protobuf support");
+#endif
+    }
+
+    cprintf("%d sets, %d ways, %d accesses per stream\n",
+            geometry.numSets, geometry.numWays, num_accesses);
+    cprintf("%-10s %-8s %12s %10s %14s\n", "policy", "stream",
+            "ns/access", "hit rate", "bytes/block");
+    for (const auto &policy : policies) {
+        for (const auto &[stream_name, stream] : streams) {
+            const Result result = run(policy, geometry, stream);
+            cprintf("%-10s %-8s %12.2f %10.4f %14.2f\n", policy.name,
+                    stream_name, result.nsPerAccess, result.hitRate,
+                    result.bytesPerBlock);
+        }
+    }
+
+    return 0;
+}
@@ -46,13 +46,14 @@ SecondChance::SecondChance(const Params &p)
 
 void
 SecondChance::useSecondChance(
-    const std::shared_ptr<SecondChanceReplData>& replacement_data) const
+    const std::shared_ptr<ReplacementData>& replacement_data) const
 {
     // Reset FIFO data
     FIFO::reset(replacement_data);
 
     // Use second chance
-    replacement_data->hasSecondChance = false;
+    static_cast<SecondChanceReplData*>(
+        replacement_data.get())->hasSecondChance = false;
 }
 
 void
@@ -62,8 +63,8 @@ SecondChance::invalidate(
     FIFO::invalidate(replacement_data);
 
     // Do not give a second chance to invalid entries
-    std::static_pointer_cast<SecondChanceReplData>(
-        replacement_data)->hasSecondChance = false;
+    static_cast<SecondChanceReplData*>(
+        replacement_data.get())->hasSecondChance = false;
 }
 
 void
@@ -73,8 +74,8 @@ SecondChance::touch(
     FIFO::touch(replacement_data);
 
     // Whenever an entry is touched, it is given a second chance
-    std::static_pointer_cast<SecondChanceReplData>(
-        replacement_data)->hasSecondChance = true;
+    static_cast<SecondChanceReplData*>(
+        replacement_data.get())->hasSecondChance = true;
 }
 
 void
@@ -84,8 +85,8 @@ SecondChance::reset(
     FIFO::reset(replacement_data);
 
     // Entries are inserted with a second chance
-    std::static_pointer_cast<SecondChanceReplData>(
-        replacement_data)->hasSecondChance = false;
+    static_cast<SecondChanceReplData*>(
+        replacement_data.get())->hasSecondChance = false;
 }
 
 ReplaceableEntry*
@@ -97,9 +98,9 @@ SecondChance::getVictim(const ReplacementCandidates& candidates) const
     // Search for invalid entries, as they have the eviction priority
     for (const auto& candidate : candidates) {
         // Cast candidate's replacement data
-        std::shared_ptr<SecondChanceReplData> candidate_replacement_data =
-            std::static_pointer_cast<SecondChanceReplData>(
-                candidate->replacementData);
+        SecondChanceReplData* candidate_replacement_data =
+            static_cast<SecondChanceReplData*>(
+                candidate->replacementData.get());
 
         // Stop iteration if found an invalid entry
         if ((candidate_replacement_data->tickInserted == Tick(0)) &&
@@ -116,13 +117,13 @@ SecondChance::getVictim(const ReplacementCandidates& candidates) const
         victim = FIFO::getVictim(candidates);
 
         // Cast victim's replacement data for code readability
-        std::shared_ptr<SecondChanceReplData> victim_replacement_data =
-            std::static_pointer_cast<SecondChanceReplData>(
-                victim->replacementData);
+        SecondChanceReplData* victim_replacement_data =
+            static_cast<SecondChanceReplData*>(
+                victim->replacementData.get());
 
         // If victim has a second chance, use it and repeat search
         if (victim_replacement_data->hasSecondChance) {
-            useSecondChance(victim_replacement_data);
+            useSecondChance(victim->replacementData);
         } else {
             // Found victim
             search_victim = false;
@@ -135,7 +136,7 @@ SecondChance::getVictim(const ReplacementCandidates& candidates) const
 std::shared_ptr<ReplacementData>
 SecondChance::instantiateEntry()
 {
-    return std::shared_ptr<ReplacementData>(new SecondChanceReplData());
+    return replDataPool.allocate();
 }
 
 } // namespace replacement_policy
@@ -75,7 +75,11 @@ class SecondChance : public FIFO
      * @param replacement_data Entry that will use its second chance.
      */
     void useSecondChance(
-        const std::shared_ptr<SecondChanceReplData>& replacement_data) const;
+        const std::shared_ptr<ReplacementData>& replacement_data) const;
+
+  private:
+    /** Storage of the replacement data of the entries. */
+    ReplacementDataPool<SecondChanceReplData> replDataPool;
 
   public:
     typedef SecondChanceRPParams Params;
@@ -78,8 +78,8 @@ SHiP::SHiP(const Params &p)
 void
 SHiP::invalidate(const std::shared_ptr<ReplacementData>& replacement_data)
 {
-    std::shared_ptr<SHiPReplData> casted_replacement_data =
-        std::static_pointer_cast<SHiPReplData>(replacement_data);
+    SHiPReplData* casted_replacement_data =
+        static_cast<SHiPReplData*>(replacement_data.get());
 
     // The predictor is detrained when an entry that has not been re-
     // referenced since insertion is invalidated
@@ -94,8 +94,8 @@ void
 SHiP::touch(const std::shared_ptr<ReplacementData>& replacement_data,
     const PacketPtr pkt)
 {
-    std::shared_ptr<SHiPReplData> casted_replacement_data =
-        std::static_pointer_cast<SHiPReplData>(replacement_data);
+    SHiPReplData* casted_replacement_data =
+        static_cast<SHiPReplData*>(replacement_data.get());
 
     // When a hit happens the SHCT entry indexed by the signature is
     // incremented
@@ -117,8 +117,8 @@ void
 SHiP::reset(const std::shared_ptr<ReplacementData>& replacement_data,
     const PacketPtr pkt)
 {
-    std::shared_ptr<SHiPReplData> casted_replacement_data =
-        std::static_pointer_cast<SHiPReplData>(replacement_data);
+    SHiPReplData* casted_replacement_data =
+        static_cast<SHiPReplData*>(replacement_data.get());
 
     // Get signature
     const SignatureType signature = getSignature(pkt);
@@ -144,7 +144,28 @@ SHiP::reset(const std::shared_ptr<ReplacementData>& replacement_data)
 std::shared_ptr<ReplacementData>
 SHiP::instantiateEntry()
 {
-    return std::shared_ptr<ReplacementData>(new SHiPReplData(numRRPVBits));
+    return replDataPool.allocate(numRRPVBits);
+}
+
+void
+SHiP::serialize(CheckpointOut &cp) const
+{
+    std::vector<uint8_t> shct(SHCT.begin(), SHCT.end());
+    SERIALIZE_CONTAINER(shct);
+}
+
+void
+SHiP::unserialize(CheckpointIn &cp)
+{
+    std::vector<uint8_t> shct;
+    UNSERIALIZE_CONTAINER(shct);
+    fatal_if(shct.size() != SHCT.size(),
+             "Checkpointed SHCT has %d entries, but %d are configured",
+             shct.size(), SHCT.size());
+    for (size_t i = 0; i < SHCT.size(); i++) {
+        SHCT[i].reset();
+        SHCT[i] += shct[i];
+    }
 }
 
 SHiPMem::SHiPMem(const SHiPMemRPParams &p) : SHiP(p) {}
@@ -115,6 +115,10 @@ class SHiP : public BRRIP
      */
     virtual SignatureType getSignature(const PacketPtr pkt) const = 0;
 
+  private:
+    /** Storage of the replacement data of the entries. */
+    ReplacementDataPool<SHiPReplData> replDataPool;
+
   public:
     typedef SHiPRPParams Params;
     SHiP(const Params &p);
@@ -153,12 +157,19 @@ class SHiP : public BRRIP
     void reset(const std::shared_ptr<ReplacementData>& replacement_data) const
         override;
 
+    /** The signatures are taken from the access packets. */
+    bool needsPacket() const override { return true; }
+
     /**
      * Instantiate a replacement data entry.
      *
      * @return A shared pointer to the new replacement data.
      */
     std::shared_ptr<ReplacementData> instantiateEntry() override;
+
+    /** Checkpoint the SHCT, so that a restored run starts warm. */
+    void serialize(CheckpointOut &cp) const override;
+    void unserialize(CheckpointIn &cp) override;
 };
 
 /** SHiP that Uses memory addresses as signatures. */
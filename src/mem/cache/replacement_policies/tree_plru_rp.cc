@@ -34,6 +34,7 @@
 
 #include "mem/cache/replacement_policies/tree_plru_rp.hh"
 
+#include <algorithm>
 #include <cmath>
 
 #include "base/intmath.hh"
@@ -103,7 +104,8 @@ TreePLRU::TreePLRUReplData::TreePLRUReplData(
 }
 
 TreePLRU::TreePLRU(const Params &p)
-  : Base(p), numLeaves(p.num_leaves), count(0), treeInstance(nullptr)
+  : Base(p), numLeaves(p.num_leaves), count(0), treeInstance(nullptr),
+    leafCandidates(numLeaves, nullptr), hasCandidate(2 * numLeaves - 1)
 {
     fatal_if(!isPowerOf2(numLeaves),
              "Number of leaves must be non-zero and a power of 2");
@@ -113,8 +115,8 @@ void
 TreePLRU::invalidate(const std::shared_ptr<ReplacementData>& replacement_data)
 {
     // Cast replacement data
-    std::shared_ptr<TreePLRUReplData> treePLRU_replacement_data =
-        std::static_pointer_cast<TreePLRUReplData>(replacement_data);
+    TreePLRUReplData* treePLRU_replacement_data =
+        static_cast<TreePLRUReplData*>(replacement_data.get());
     PLRUTree* tree = treePLRU_replacement_data->tree.get();
 
     // Index of the tree entry we are currently checking
@@ -139,8 +141,8 @@ TreePLRU::touch(const std::shared_ptr<ReplacementData>& replacement_data)
 const
 {
     // Cast replacement data
-    std::shared_ptr<TreePLRUReplData> treePLRU_replacement_data =
-        std::static_pointer_cast<TreePLRUReplData>(replacement_data);
+    TreePLRUReplData* treePLRU_replacement_data =
+        static_cast<TreePLRUReplData*>(replacement_data.get());
     PLRUTree* tree = treePLRU_replacement_data->tree.get();
 
     // Index of the tree entry we are currently checking
@@ -175,8 +177,13 @@ TreePLRU::getVictim(const ReplacementCandidates& candidates) const
     assert(candidates.size() > 0);
 
     // Get tree
-    const PLRUTree* tree = std::static_pointer_cast<TreePLRUReplData>(
-            candidates[0]->replacementData)->tree.get();
+    const PLRUTree* tree = static_cast<TreePLRUReplData*>(
+            candidates[0]->replacementData.get())->tree.get();
+
+    // A partitioned cache may only give some of the leaves of the tree
+    if (candidates.size() != numLeaves) {
+        return getPartialVictim(candidates, *tree);
+    }
 
     // Index of the tree entry we are currently checking. Start with root.
     uint64_t tree_index = 0;
@@ -196,23 +203,61 @@ TreePLRU::getVictim(const ReplacementCandidates& candidates) const
     return candidates[tree_index - (numLeaves - 1)];
 }
 
+ReplaceableEntry*
+TreePLRU::getPartialVictim(const ReplacementCandidates& candidates,
+                           const PLRUTree& tree) const
+{
+    // Candidate of each leaf, and whether each subtree has a candidate.
+    // Only the leaves with a candidate are ever read, so the candidates
+    // left over from previous calls need not be cleared.
+    std::fill(hasCandidate.begin(), hasCandidate.end(), false);
+    for (const auto& candidate : candidates) {
+        uint64_t tree_index = static_cast<TreePLRUReplData*>(
+            candidate->replacementData.get())->index;
+        assert(tree_index >= numLeaves - 1 &&
+               tree_index < hasCandidate.size());
+        leafCandidates[tree_index - (numLeaves - 1)] = candidate;
+        while (!hasCandidate[tree_index]) {
+            hasCandidate[tree_index] = true;
+            if (tree_index == 0) {
+                break;
+            }
+            tree_index = parentIndex(tree_index);
+        }
+    }
+
+    // Follow the tree, unless the subtree it points to has no candidate
+    uint64_t tree_index = 0;
+    while (tree_index < tree.size()) {
+        const uint64_t next_index = tree[tree_index] ?
+            rightSubtreeIndex(tree_index) : leftSubtreeIndex(tree_index);
+        if (hasCandidate[next_index]) {
+            tree_index = next_index;
+        } else {
+            tree_index = tree[tree_index] ? leftSubtreeIndex(tree_index) :
+                rightSubtreeIndex(tree_index);
+        }
+    }
+
+    return leafCandidates[tree_index - (numLeaves - 1)];
+}
+
 std::shared_ptr<ReplacementData>
 TreePLRU::instantiateEntry()
 {
     // Generate a tree instance every numLeaves created
     if (count % numLeaves == 0) {
-        treeInstance = new PLRUTree(numLeaves - 1, false);
+        treeInstance = std::make_shared<PLRUTree>(numLeaves - 1, false);
     }
 
     // Create replacement data using current tree instance
-    TreePLRUReplData* treePLRUReplData = new TreePLRUReplData(
-        (count % numLeaves) + numLeaves - 1,
-        std::shared_ptr<PLRUTree>(treeInstance));
+    std::shared_ptr<ReplacementData> treePLRUReplData = replDataPool.allocate(
+        (count % numLeaves) + numLeaves - 1, treeInstance);
 
     // Update instance counter
     count++;
 
-    return std::shared_ptr<ReplacementData>(treePLRUReplData);
+    return treePLRUReplData;
 }
 
 } // namespace replacement_policy
@@ -123,7 +123,7 @@ class TreePLRU : public Base
     /**
      * Holds the latest temporary tree instance created by instantiateEntry().
      */
-    PLRUTree* treeInstance;
+    std::shared_ptr<PLRUTree> treeInstance;
 
   protected:
     /**
@@ -155,6 +155,30 @@ class TreePLRU : public Base
         TreePLRUReplData(const uint64_t index, std::shared_ptr<PLRUTree> tree);
     };
 
+  private:
+    /** Storage of the replacement data of the entries. */
+    ReplacementDataPool<TreePLRUReplData> replDataPool;
+
+    /**
+     * Scratch storage of getPartialVictim(), sized once so that finding a
+     * victim does not allocate: the candidate of each leaf, and whether
+     * each node, leaves included, has a candidate in its subtree.
+     */
+    mutable std::vector<ReplaceableEntry*> leafCandidates;
+    mutable std::vector<bool> hasCandidate;
+
+    /**
+     * Find a victim among some of the leaves of a tree, e.g., the ways of
+     * a partition. The tree bits are followed as long as they point to a
+     * subtree with candidates.
+     *
+     * @param candidates Replacement candidates, which share the tree.
+     * @param tree The tree of the candidates.
+     * @return Replacement entry to be replaced.
+     */
+    ReplaceableEntry* getPartialVictim(const ReplacementCandidates& candidates,
+                                       const PLRUTree& tree) const;
+
   public:
     typedef TreePLRURPParams Params;
     TreePLRU(const Params &p);
@@ -60,6 +60,10 @@ class WeightedLRU : public LRU
          */
         WeightedLRUReplData() : LRUReplData(), last_occ_ptr(0) {}
     };
+  private:
+    /** Storage of the replacement data of the entries. */
+    ReplacementDataPool<WeightedLRUReplData> replDataPool;
+
   public:
     typedef WeightedLRURPParams Params;
     WeightedLRU(const Params &p);
@@ -37,6 +37,7 @@ from m5.params import *
 from m5.proxy import *
 from m5.objects.ClockedObject import ClockedObject
 from m5.objects.IndexingPolicies import *
+from m5.objects.PartitioningPolicies import *
 
 class BaseTags(ClockedObject):
     type = 'BaseTags'
@@ -84,6 +85,16 @@ class BaseSetAssoc(BaseTags):
     replacement_policy = Param.BaseReplacementPolicy(
         Parent.replacement_policy, "Replacement policy")
 
+    # Keep a packed copy of the tags of each set, so that a lookup compares
+    # all ways within a few host cache lines and only touches the matching
+    # block. Requires a set associative indexing policy.
+    packed_tags = Param.Bool(False,
+        "Match the tags of a set in a packed array")
+
+    # Restrict the blocks the requestors of each partition may victimize
+    partitioning_policy = Param.BasePartitioningPolicy(NULL,
+        "Partitioning policy")
+
 class SectorTags(BaseTags):
     type = 'SectorTags'
     cxx_header = "mem/cache/tags/sector_tags.hh"
@@ -45,21 +45,31 @@
 
 #include "mem/cache/tags/base_set_assoc.hh"
 
+#include <algorithm>
 #include <string>
 
+#include "base/bitfield.hh"
 #include "base/intmath.hh"
 
 namespace gem5
 {
 
 BaseSetAssoc::BaseSetAssoc(const Params &p)
-    :BaseTags(p), allocAssoc(p.assoc), blks(p.size / p.block_size),
-     sequentialAccess(p.sequential_access),
-     replacementPolicy(p.replacement_policy)
+    :BaseTags(p), assoc(p.assoc), allocAssoc(p.assoc),
+     blks(p.size / p.block_size), sequentialAccess(p.sequential_access),
+     replacementPolicy(p.replacement_policy),
+     partitioningPolicy(p.partitioning_policy), setAssocIndexing(nullptr)
 {
     // There must be a indexing policy
     fatal_if(!p.indexing_policy, "An indexing policy is required");
 
+    if (p.packed_tags) {
+        setAssocIndexing = dynamic_cast<SetAssociative*>(p.indexing_policy);
+        fatal_if(!setAssocIndexing, "Packed tags require a set associative "
+                 "indexing policy");
+        packedTags.resize(numBlocks, 0);
+    }
+
     // Check parameters
     if (blkSize < 4 || !isPowerOf2(blkSize)) {
         fatal("Block size must be at least 4 and a power of 2");
@@ -81,26 +91,80 @@ BaseSetAssoc::tagsInit()
         blk->data = &dataBlks[blkSize*blk_index];
 
         // Associate a replacement data entry to the block
-        blk->replacementData = replacementPolicy->instantiateEntry();
+        blk->replacementData =
+            replacementPolicy->instantiateEntry(blk->getSet(), blk->getWay());
+    }
+
+    if (partitioningPolicy) {
+        partitioningPolicy->setGeometry(numBlocks / assoc, assoc, blkSize);
     }
 }
 
 void
 BaseSetAssoc::invalidate(CacheBlk *blk)
 {
+    if (partitioningPolicy) {
+        const uint64_t partition =
+            partitioningPolicy->getPartition(blk->getSrcRequestorId());
+        if (partition != partitioning_policy::Base::NoPartition) {
+            partitioningPolicy->notifyInvalidate(partition);
+        }
+    }
+
     BaseTags::invalidate(blk);
 
     // Decrease the number of tags in use
     stats.tagsInUse--;
 
+    updatePackedTag(blk);
+
     // Invalidate replacement data
     replacementPolicy->invalidate(blk->replacementData);
 }
 
+void
+BaseSetAssoc::resetStats()
+{
+    BaseTags::resetStats();
+    if (partitioningPolicy)
+        partitioningPolicy->resetStats();
+}
+
+CacheBlk*
+BaseSetAssoc::findBlock(Addr addr, bool is_secure) const
+{
+    if (packedTags.empty()) {
+        return BaseTags::findBlock(addr, is_secure);
+    }
+
+    const uint32_t set = setAssocIndexing->extractSet(addr);
+    const Addr *tags = &packedTags[set * assoc];
+    const Addr packed_tag = packTag(extractTag(addr), is_secure);
+
+    // Compare up to 64 ways at a time into a bit mask. The loop has no
+    // early exit, so the compiler can vectorize the comparisons
+    for (unsigned first_way = 0; first_way < assoc; first_way += 64) {
+        const unsigned num_ways = std::min(assoc - first_way, 64u);
+        uint64_t matches = 0;
+        for (unsigned way = 0; way < num_ways; way++) {
+            matches |= uint64_t(tags[first_way + way] == packed_tag) << way;
+        }
+        if (matches) {
+            return static_cast<CacheBlk*>(indexingPolicy->getEntry(set,
+                first_way + ctz64(matches)));
+        }
+    }
+
+    // Did not find block
+    return nullptr;
+}
+
 void
 BaseSetAssoc::moveBlock(CacheBlk *src_blk, CacheBlk *dest_blk)
 {
     BaseTags::moveBlock(src_blk, dest_blk);
+    updatePackedTag(src_blk);
+    updatePackedTag(dest_blk);
 
     // Since the blocks were using different replacement data pointers,
     // we must touch the replacement data of the new entry, and invalidate
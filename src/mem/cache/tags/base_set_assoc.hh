@@ -59,6 +59,8 @@
 #include "mem/cache/replacement_policies/replaceable_entry.hh"
 #include "mem/cache/tags/base.hh"
 #include "mem/cache/tags/indexing_policies/base.hh"
+#include "mem/cache/tags/indexing_policies/set_associative.hh"
+#include "mem/cache/tags/partitioning_policies/base.hh"
 #include "mem/packet.hh"
 #include "params/BaseSetAssoc.hh"
 
@@ -75,6 +77,9 @@ namespace gem5
 class BaseSetAssoc : public BaseTags
 {
   protected:
+    /** The associativity of the cache. */
+    const unsigned assoc;
+
     /** The allocatable associativity of the cache (alloc mask). */
     unsigned allocAssoc;
 
@@ -87,6 +92,53 @@ class BaseSetAssoc : public BaseTags
     /** Replacement policy */
     replacement_policy::Base *replacementPolicy;
 
+    /** Partitioning policy, if the cache is partitioned. */
+    partitioning_policy::Base *partitioningPolicy;
+
+    /** The replacement candidates of a partition, when partitioned. */
+    std::vector<ReplaceableEntry*> partitionCandidates;
+
+    /**
+     * The indexing policy, when the packed tags are used. Its sets are
+     * laid out in packedTags way by way.
+     */
+    SetAssociative *setAssocIndexing;
+
+    /**
+     * Packed copy of the tag, secure and valid bits of every block, as
+     * produced by packTag(), indexed by set * assoc + way. Invalid blocks
+     * hold 0, which never matches a packed tag. Empty when the packed
+     * layout is not used.
+     */
+    std::vector<Addr> packedTags;
+
+    /**
+     * Pack a tag with its secure bit and a valid bit.
+     *
+     * @param tag The tag.
+     * @param is_secure Whether the tag belongs to the secure space.
+     * @return The packed tag.
+     */
+    static Addr
+    packTag(Addr tag, bool is_secure)
+    {
+        return (tag << 2) | (Addr(is_secure) << 1) | 1;
+    }
+
+    /**
+     * Copy the tag of a block to the packed tags, if they are used.
+     *
+     * @param blk The block whose tag, secure or valid bits changed.
+     */
+    void
+    updatePackedTag(const CacheBlk *blk)
+    {
+        if (!packedTags.empty()) {
+            packedTags[blk->getSet() * assoc + blk->getWay()] =
+                blk->isValid() ? packTag(blk->getTag(), blk->isSecure()) : 0;
+        }
+    }
+
   public:
     /** Convenience typedef. */
      typedef BaseSetAssocParams Params;
@@ -114,6 +166,23 @@ class BaseSetAssoc : public BaseTags
      */
     void invalidate(CacheBlk *blk) override;
 
+    /**
+     * Reset the stats of the tags, and those of the partitioning policy,
+     * which may be shared with other tags rather than be a child of these.
+     */
+    void resetStats() override;
+
+    /**
+     * Finds the block in the cache. With the packed tags, all ways of the
+     * set are compared in the packed array, and only the matching block is
+     * accessed.
+     *
+     * @param addr The address to find.
+     * @param is_secure True if the target memory space is secure.
+     * @return Pointer to the cache block if found.
+     */
+    CacheBlk* findBlock(Addr addr, bool is_secure) const override;
+
     /**
      * Access block and update replacement data. May not succeed, in which case
      * nullptr is returned. This has all the implications of a cache access and
@@ -149,6 +218,15 @@ class BaseSetAssoc : public BaseTags
             replacementPolicy->touch(blk->replacementData, pkt);
         }
 
+        if (partitioningPolicy) {
+            const uint64_t partition =
+                partitioningPolicy->getPartition(pkt->requestorId());
+            if (partition != partitioning_policy::Base::NoPartition) {
+                partitioningPolicy->notifyAccess(partition, pkt->getAddr(),
+                                                 blk != nullptr);
+            }
+        }
+
         // The tag lookup latency is the same for a hit or a miss
         lat = lookupLatency;
 
@@ -157,25 +235,38 @@ class BaseSetAssoc : public BaseTags
 
     /**
      * Find replacement victim based on address. The list of evicted blocks
-     * only contains the victim.
+     * only contains the victim. If the cache is partitioned, the victim is
+     * chosen among the entries the partition of the requestor may use.
      *
      * @param addr Address to find a victim for.
      * @param is_secure True if the target memory space is secure.
      * @param size Size, in bits, of new block to allocate.
      * @param evict_blks Cache blocks to be evicted.
+     * @param requestor_id ID of the requestor allocating the block.
      * @return Cache block to be replaced.
      */
     CacheBlk* findVictim(Addr addr, const bool is_secure,
                          const std::size_t size,
-                         std::vector<CacheBlk*>& evict_blks) override
+                         std::vector<CacheBlk*>& evict_blks,
+                         const RequestorID requestor_id) override
     {
         // Get possible entries to be victimized
-        const std::vector<ReplaceableEntry*> entries =
-            indexingPolicy->getPossibleEntries(addr);
+        const std::vector<ReplaceableEntry*>* entries =
+            &indexingPolicy->getPossibleEntries(addr);
+
+        if (partitioningPolicy) {
+            const uint64_t partition =
+                partitioningPolicy->getPartition(requestor_id);
+            if (partition != partitioning_policy::Base::NoPartition) {
+                partitioningPolicy->filterCandidates(partition, *entries,
+                                                     partitionCandidates);
+                entries = &partitionCandidates;
+            }
+        }
 
         // Choose replacement victim from replacement candidates
         CacheBlk* victim = static_cast<CacheBlk*>(replacementPolicy->getVictim(
-                                entries));
+                                *entries));
 
         // There is only one eviction for this replacement
         evict_blks.push_back(victim);
@@ -197,6 +288,16 @@ class BaseSetAssoc : public BaseTags
         // Increment tag counter
         stats.tagsInUse++;
 
+        if (partitioningPolicy) {
+            const uint64_t partition =
+                partitioningPolicy->getPartition(blk->getSrcRequestorId());
+            if (partition != partitioning_policy::Base::NoPartition) {
+                partitioningPolicy->notifyInsert(partition);
+            }
+        }
+
+        updatePackedTag(blk);
+
         // Update replacement policy
         replacementPolicy->reset(blk->replacementData, pkt);
     }
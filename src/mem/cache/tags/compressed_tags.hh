@@ -106,7 +106,8 @@ class CompressedTags : public SectorTags
      */
     CacheBlk* findVictim(Addr addr, const bool is_secure,
                          const std::size_t compressed_size,
-                         std::vector<CacheBlk*>& evict_blks) override;
+                         std::vector<CacheBlk*>& evict_blks,
+                         const RequestorID requestor_id) override;
 
     /**
      * Visit each sub-block in the tags and apply a visitor.
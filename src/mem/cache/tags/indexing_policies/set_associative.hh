@@ -81,7 +81,7 @@ class ReplaceableEntry;
  */
 class SetAssociative : public BaseIndexingPolicy
 {
-  protected:
+  public:
     /**
      * Apply a hash function to calculate address set.
      *
@@ -90,7 +90,6 @@ class SetAssociative : public BaseIndexingPolicy
      */
     virtual uint32_t extractSet(const Addr addr) const;
 
-  public:
     /**
      * Convenience typedef.
      */
@@ -110,13 +109,14 @@ class SetAssociative : public BaseIndexingPolicy
      * Find all possible entries for insertion and replacement of an address.
      * Should be called immediately before ReplacementPolicy's findVictim()
      * not to break cache resizing.
-     * Returns entries in all ways belonging to the set of the address.
+     * Returns entries in all ways belonging to the set of the address, which
+     * are the set itself, so no copy is made.
      *
      * @param addr The addr to a find possible entries for.
      * @return The possible entries.
      */
-    std::vector<ReplaceableEntry*> getPossibleEntries(const Addr addr) const
-                                                                     override;
+    const std::vector<ReplaceableEntry*>&
+    getPossibleEntries(const Addr addr) const override;
 
     /**
      * Regenerate an entry's address from its tag and assigned set and way.
@@ -85,6 +85,12 @@ class SkewedAssociative : public BaseIndexingPolicy
      */
     const int msbShift;
 
+    /**
+     * Holds the possible entries of the last address looked up, so that they
+     * are not allocated on every lookup.
+     */
+    mutable std::vector<ReplaceableEntry*> possibleEntries;
+
     /**
      * The hash function itself. Uses the hash function H, as described in
      * "Skewed-Associative Caches", from Seznec et al. (section 3.3): It
@@ -158,10 +164,10 @@ class SkewedAssociative : public BaseIndexingPolicy
      * not to break cache resizing.
      *
      * @param addr The addr to a find possible entries for.
-     * @return The possible entries.
+     * @return The possible entries, valid until the next call.
      */
-    std::vector<ReplaceableEntry*> getPossibleEntries(const Addr addr) const
-                                                                   override;
+    const std::vector<ReplaceableEntry*>&
+    getPossibleEntries(const Addr addr) const override;
 
     /**
      * Regenerate an entry's address from its tag and assigned set and way.
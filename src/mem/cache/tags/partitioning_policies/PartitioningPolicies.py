@@ -0,0 +1,72 @@
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+from m5.params import *
+from m5.proxy import *
+from m5.SimObject import SimObject, PyBindMethod
+
+class BasePartitioningPolicy(SimObject):
+    type = 'BasePartitioningPolicy'
+    abstract = True
+    cxx_class = 'gem5::partitioning_policy::Base'
+    cxx_header = "mem/cache/tags/partitioning_policies/base.hh"
+
+    cxx_exports = [
+        PyBindMethod("getOccupancy"),
+    ]
+
+    system = Param.System(Parent.any, "System the cache belongs to")
+
+    # Each partition is given as a space separated list of requestor name
+    # prefixes, e.g., "system.cpu0 system.l2.prefetcher". Requestors that
+    # belong to no partition, such as the writebacks, are not restricted.
+    partitions = VectorParam.String("Requestors of each partition")
+
+class WayPartitioningPolicy(BasePartitioningPolicy):
+    type = 'WayPartitioningPolicy'
+    cxx_class = 'gem5::partitioning_policy::WayPartitioning'
+    cxx_header = "mem/cache/tags/partitioning_policies/way_partitioning.hh"
+
+    cxx_exports = [
+        PyBindMethod("setWayMask"),
+        PyBindMethod("getWayMask"),
+    ]
+
+    # One mask of allocatable ways per partition, as in Intel CAT. Masks
+    # may overlap. By default every partition may allocate in every way.
+    way_masks = VectorParam.UInt64([],
+        "Bit mask of the ways each partition may allocate in")
+
+class UtilityPartitioningPolicy(WayPartitioningPolicy):
+    type = 'UtilityPartitioningPolicy'
+    cxx_class = 'gem5::partitioning_policy::UtilityPartitioning'
+    cxx_header = \
+        "mem/cache/tags/partitioning_policies/utility_partitioning.hh"
+
+    # Utility monitors sample the sets of the cache with shadow LRU tags
+    # for each partition, and the ways are periodically re-distributed
+    # with the lookahead algorithm of UCP.
+    umon_sets = Param.Unsigned(32, "Number of sets sampled by the monitors")
+    epoch = Param.Unsigned(1000000,
+        "Number of partitioned accesses between re-partitions")
+    min_ways = Param.Unsigned(1, "Minimum number of ways of a partition")
@@ -0,0 +1,155 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "mem/cache/tags/partitioning_policies/base.hh"
+
+#include <sstream>
+
+#include "base/intmath.hh"
+#include "base/logging.hh"
+#include "sim/system.hh"
+
+namespace gem5
+{
+
+namespace partitioning_policy
+{
+
+const uint64_t Base::NoPartition;
+const uint64_t Base::Unresolved;
+
+Base::Base(const Params &p)
+  : SimObject(p), system(p.system), numSets(0), assoc(0), blkShift(0),
+    occupancy(p.partitions.size(), 0), stats(*this)
+{
+    for (const auto &partition : p.partitions) {
+        std::istringstream names(partition);
+        prefixes.emplace_back();
+        for (std::string prefix; names >> prefix;) {
+            prefixes.back().push_back(prefix);
+        }
+        fatal_if(prefixes.back().empty(),
+                 "Partition %d of %s has no requestors\n",
+                 prefixes.size() - 1, name());
+    }
+}
+
+void
+Base::setGeometry(uint32_t num_sets, uint32_t num_ways, unsigned blk_size)
+{
+    numSets = num_sets;
+    assoc = num_ways;
+    blkShift = floorLog2(blk_size);
+}
+
+uint64_t
+Base::getPartition(RequestorID requestor_id)
+{
+    if (requestor_id >= requestorPartitions.size()) {
+        requestorPartitions.resize(requestor_id + 1, Unresolved);
+    }
+
+    uint64_t &partition = requestorPartitions[requestor_id];
+    if (partition == Unresolved) {
+        // A prefix matches whole components of the requestor name, so
+        // that system.cpu1 does not match system.cpu10
+        const std::string name = system->getRequestorName(requestor_id);
+        partition = NoPartition;
+        for (uint64_t i = 0; i < prefixes.size() &&
+             partition == NoPartition; i++) {
+            for (const auto &prefix : prefixes[i]) {
+                if (name.compare(0, prefix.size(), prefix) == 0 &&
+                    (name.size() == prefix.size() ||
+                     name[prefix.size()] == '.')) {
+                    partition = i;
+                    break;
+                }
+            }
+        }
+    }
+    return partition;
+}
+
+uint64_t
+Base::getOccupancy(uint64_t partition) const
+{
+    fatal_if(partition >= getNumPartitions(),
+             "%s has no partition %d\n", name(), partition);
+    return occupancy[partition];
+}
+
+void
+Base::notifyAccess(uint64_t partition, Addr addr, bool hit)
+{
+    if (hit) {
+        stats.hits[partition]++;
+    } else {
+        stats.misses[partition]++;
+    }
+}
+
+void
+Base::notifyInsert(uint64_t partition)
+{
+    occupancy[partition]++;
+    stats.occupancies[partition] = occupancy[partition];
+}
+
+void
+Base::notifyInvalidate(uint64_t partition)
+{
+    assert(occupancy[partition] > 0);
+    occupancy[partition]--;
+    stats.occupancies[partition] = occupancy[partition];
+}
+
+Base::PartitioningStats::PartitioningStats(Base &_policy)
+  : statistics::Group(&_policy), policy(_policy),
+    ADD_STAT(hits, statistics::units::Count::get(),
+             "Number of tag lookups that hit, per partition"),
+    ADD_STAT(misses, statistics::units::Count::get(),
+             "Number of tag lookups that missed, per partition"),
+    ADD_STAT(occupancies, statistics::units::Count::get(),
+             "Average number of blocks held by each partition")
+{
+}
+
+void
+Base::PartitioningStats::regStats()
+{
+    statistics::Group::regStats();
+
+    hits.init(policy.getNumPartitions());
+    misses.init(policy.getNumPartitions());
+    occupancies.init(policy.getNumPartitions());
+    for (uint64_t i = 0; i < policy.getNumPartitions(); i++) {
+        hits.subname(i, std::to_string(i));
+        misses.subname(i, std::to_string(i));
+        occupancies.subname(i, std::to_string(i));
+    }
+}
+
+} // namespace partitioning_policy
+} // namespace gem5
@@ -0,0 +1,179 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** @file
+ * Declaration of a common framework for cache partitioning policies.
+ */
+
+#ifndef __MEM_CACHE_TAGS_PARTITIONING_POLICIES_BASE_HH__
+#define __MEM_CACHE_TAGS_PARTITIONING_POLICIES_BASE_HH__
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "base/statistics.hh"
+#include "base/types.hh"
+#include "mem/request.hh"
+#include "params/BasePartitioningPolicy.hh"
+#include "sim/sim_object.hh"
+
+namespace gem5
+{
+
+class ReplaceableEntry;
+class System;
+
+namespace partitioning_policy
+{
+
+/**
+ * A common base class of cache partitioning policies. The requestors of
+ * the cache are grouped in partitions, and a policy restricts the entries
+ * the requests of each partition may victimize. The tags filter the
+ * replacement candidates before handing them to the replacement policy,
+ * so any replacement policy can be partitioned.
+ */
+class Base : public SimObject
+{
+  public:
+    /** Partition of the requestors that belong to no partition. */
+    static const uint64_t NoPartition = ~uint64_t(0);
+
+  protected:
+    /** Partition of the requestors that were not looked up yet. */
+    static const uint64_t Unresolved = NoPartition - 1;
+
+    /** System of the cache, to get the names of the requestors. */
+    System *system;
+
+    /** Requestor name prefixes of each partition. */
+    std::vector<std::vector<std::string>> prefixes;
+
+    /** Partition of each requestor ID, resolved on first use. */
+    std::vector<uint64_t> requestorPartitions;
+
+    /** Number of sets of the cache. */
+    uint32_t numSets;
+
+    /** Associativity of the cache. */
+    uint32_t assoc;
+
+    /** Log2 of the block size of the cache. */
+    unsigned blkShift;
+
+    /** Number of blocks each partition currently holds. */
+    std::vector<uint64_t> occupancy;
+
+    struct PartitioningStats : public statistics::Group
+    {
+        PartitioningStats(Base &policy);
+
+        void regStats() override;
+
+        const Base &policy;
+
+        /** Number of hits of each partition. */
+        statistics::Vector hits;
+
+        /** Number of misses of each partition. */
+        statistics::Vector misses;
+
+        /** Average number of blocks held by each partition. */
+        statistics::AverageVector occupancies;
+    } stats;
+
+  public:
+    typedef BasePartitioningPolicyParams Params;
+    Base(const Params &p);
+    virtual ~Base() = default;
+
+    /**
+     * Inform the policy of the geometry of the cache, before any access.
+     *
+     * @param num_sets Number of sets of the cache.
+     * @param num_ways Associativity of the cache.
+     * @param blk_size Block size of the cache, in bytes.
+     */
+    virtual void setGeometry(uint32_t num_sets, uint32_t num_ways,
+                             unsigned blk_size);
+
+    /** @return Number of partitions. */
+    uint64_t getNumPartitions() const { return prefixes.size(); }
+
+    /**
+     * Get the partition a requestor belongs to.
+     *
+     * @param requestor_id ID of the requestor.
+     * @return The partition, or NoPartition.
+     */
+    uint64_t getPartition(RequestorID requestor_id);
+
+    /**
+     * @param partition The partition.
+     * @return Number of blocks the partition currently holds.
+     */
+    uint64_t getOccupancy(uint64_t partition) const;
+
+    /**
+     * Select the replacement candidates a partition may victimize.
+     *
+     * @param partition The partition allocating a block.
+     * @param entries All the candidates of the address allocated.
+     * @param candidates Filled with the candidates of the partition, which
+     *        must not be empty.
+     */
+    virtual void filterCandidates(uint64_t partition,
+        const std::vector<ReplaceableEntry*> &entries,
+        std::vector<ReplaceableEntry*> &candidates) const = 0;
+
+    /**
+     * Notify the policy of a tag lookup of a partition.
+     *
+     * @param partition The partition accessing the cache.
+     * @param addr The address accessed.
+     * @param hit Whether the lookup hit.
+     */
+    virtual void notifyAccess(uint64_t partition, Addr addr, bool hit);
+
+    /**
+     * Notify the policy that a partition inserted a block.
+     *
+     * @param partition The partition of the requestor of the block.
+     */
+    void notifyInsert(uint64_t partition);
+
+    /**
+     * Notify the policy that a block of a partition was invalidated.
+     *
+     * @param partition The partition of the requestor of the block.
+     */
+    void notifyInvalidate(uint64_t partition);
+};
+
+} // namespace partitioning_policy
+} // namespace gem5
+
+#endif // __MEM_CACHE_TAGS_PARTITIONING_POLICIES_BASE_HH__
@@ -0,0 +1,165 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "mem/cache/tags/partitioning_policies/utility_partitioning.hh"
+
+#include <algorithm>
+
+#include "base/bitfield.hh"
+#include "base/logging.hh"
+#include "base/trace.hh"
+#include "debug/CacheRepl.hh"
+#include "params/UtilityPartitioningPolicy.hh"
+
+namespace gem5
+{
+
+namespace partitioning_policy
+{
+
+UtilityPartitioning::UtilityPartitioning(const Params &p)
+  : WayPartitioning(p), umonSets(p.umon_sets), epoch(p.epoch),
+    minWays(p.min_ways), samplingStride(1), epochAccesses(0),
+    utilityStats(*this)
+{
+    fatal_if(umonSets == 0, "%s must sample at least one set\n", name());
+    fatal_if(epoch == 0, "The epoch of %s must not be empty\n", name());
+    fatal_if(minWays == 0, "The partitions of %s must have at least one "
+             "way\n", name());
+}
+
+void
+UtilityPartitioning::setGeometry(uint32_t num_sets, uint32_t num_ways,
+                                 unsigned blk_size)
+{
+    WayPartitioning::setGeometry(num_sets, num_ways, blk_size);
+
+    fatal_if(getNumPartitions() * minWays > assoc,
+             "%s cannot give %d ways to each of its %d partitions\n",
+             name(), minWays, getNumPartitions());
+
+    umonSets = std::min(umonSets, numSets);
+    samplingStride = numSets / umonSets;
+    shadowTags.assign(getNumPartitions() * umonSets * assoc, MaxAddr);
+    wayHits.assign(getNumPartitions() * assoc, 0);
+}
+
+void
+UtilityPartitioning::notifyAccess(uint64_t partition, Addr addr, bool hit)
+{
+    WayPartitioning::notifyAccess(partition, addr, hit);
+
+    // Only the sampled sets are monitored. The sets are indexed as with
+    // the set associative indexing policy
+    const Addr line = addr >> blkShift;
+    const uint32_t set = line % numSets;
+    if (set % samplingStride == 0 && set / samplingStride < umonSets) {
+        Addr *const stack = &shadowTags[
+            (partition * umonSets + set / samplingStride) * assoc];
+        uint32_t position = 0;
+        while (position < assoc - 1 && stack[position] != line) {
+            position++;
+        }
+        if (stack[position] == line) {
+            wayHits[partition * assoc + position]++;
+        }
+
+        // Move the line to the MRU position, dropping the LRU line on a
+        // miss
+        std::copy_backward(stack, stack + position, stack + position + 1);
+        stack[0] = line;
+    }
+
+    if (++epochAccesses >= epoch) {
+        repartition();
+    }
+}
+
+void
+UtilityPartitioning::repartition()
+{
+    const uint64_t num_partitions = getNumPartitions();
+
+    // Hits of a partition at the LRU positions [from, to)
+    auto utility = [this](uint64_t partition, uint32_t from, uint32_t to) {
+        uint64_t hits = 0;
+        for (uint32_t position = from; position < to; position++) {
+            hits += wayHits[partition * assoc + position];
+        }
+        return hits;
+    };
+
+    // Lookahead: give the partition with the highest marginal utility the
+    // number of ways that achieves it, until no way is left
+    std::vector<uint32_t> allocation(num_partitions, minWays);
+    uint32_t balance = assoc - num_partitions * minWays;
+    while (balance > 0) {
+        double best_utility = -1;
+        uint64_t best_partition = 0;
+        uint32_t best_ways = 1;
+        for (uint64_t partition = 0; partition < num_partitions;
+             partition++) {
+            const uint32_t allocated = allocation[partition];
+            for (uint32_t ways = 1; ways <= balance; ways++) {
+                const double marginal_utility = double(utility(partition,
+                    allocated, allocated + ways)) / ways;
+                if (marginal_utility > best_utility) {
+                    best_utility = marginal_utility;
+                    best_partition = partition;
+                    best_ways = ways;
+                }
+            }
+        }
+        allocation[best_partition] += best_ways;
+        balance -= best_ways;
+    }
+
+    // Each partition gets a contiguous range of ways
+    uint32_t first_way = 0;
+    for (uint64_t partition = 0; partition < num_partitions; partition++) {
+        DPRINTF(CacheRepl, "%s: partition %d gets %d ways\n", name(),
+                partition, allocation[partition]);
+        setWayMask(partition, mask(allocation[partition]) << first_way);
+        first_way += allocation[partition];
+    }
+
+    // Age the monitors, so that they follow phase changes
+    for (auto &hits : wayHits) {
+        hits /= 2;
+    }
+    epochAccesses = 0;
+    utilityStats.repartitions++;
+}
+
+UtilityPartitioning::UtilityPartitioningStats::UtilityPartitioningStats(
+    UtilityPartitioning &policy)
+  : statistics::Group(&policy),
+    ADD_STAT(repartitions, statistics::units::Count::get(),
+             "Number of re-distributions of the ways")
+{
+}
+
+} // namespace partitioning_policy
+} // namespace gem5
@@ -0,0 +1,113 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** @file
+ * Declaration of a utility-based way partitioning policy.
+ */
+
+#ifndef __MEM_CACHE_TAGS_PARTITIONING_POLICIES_UTILITY_PARTITIONING_HH__
+#define __MEM_CACHE_TAGS_PARTITIONING_POLICIES_UTILITY_PARTITIONING_HH__
+
+#include <cstdint>
+#include <vector>
+
+#include "mem/cache/tags/partitioning_policies/way_partitioning.hh"
+
+namespace gem5
+{
+
+struct UtilityPartitioningPolicyParams;
+
+namespace partitioning_policy
+{
+
+/**
+ * Utility-based cache partitioning (UCP), from Qureshi and Patt, "Utility-
+ * Based Cache Partitioning: A Low-Overhead, High-Performance, Runtime
+ * Mechanism to Partition Shared Caches", MICRO 2006.
+ *
+ * A utility monitor of each partition keeps LRU shadow tags of a few
+ * sampled sets, as if the partition had the whole cache, and counts the
+ * hits at each position of the LRU stacks. Every epoch the ways are
+ * re-distributed with the lookahead algorithm, which repeatedly gives
+ * ways to the partition with the highest marginal utility, and the hit
+ * counters are halved. Each partition gets a contiguous range of ways.
+ */
+class UtilityPartitioning : public WayPartitioning
+{
+  protected:
+    /** Number of sets sampled by the utility monitors. */
+    unsigned umonSets;
+
+    /** Number of partitioned accesses between re-partitions. */
+    const unsigned epoch;
+
+    /** Minimum number of ways of a partition. */
+    const unsigned minWays;
+
+    /** Distance between the sampled sets. */
+    uint32_t samplingStride;
+
+    /**
+     * Shadow tags of the sampled sets of each partition, indexed by
+     * (partition * umonSets + sampled set) * assoc + LRU position, the
+     * MRU first. Unused positions hold MaxAddr.
+     */
+    std::vector<Addr> shadowTags;
+
+    /**
+     * Hits of each partition at each LRU position, indexed by
+     * partition * assoc + position.
+     */
+    std::vector<uint64_t> wayHits;
+
+    /** Number of partitioned accesses in the current epoch. */
+    unsigned epochAccesses;
+
+    struct UtilityPartitioningStats : public statistics::Group
+    {
+        UtilityPartitioningStats(UtilityPartitioning &policy);
+
+        /** Number of re-partitions. */
+        statistics::Scalar repartitions;
+    } utilityStats;
+
+    /** Re-distribute the ways and start a new epoch. */
+    void repartition();
+
+  public:
+    typedef UtilityPartitioningPolicyParams Params;
+    UtilityPartitioning(const Params &p);
+
+    void setGeometry(uint32_t num_sets, uint32_t num_ways,
+                     unsigned blk_size) override;
+
+    void notifyAccess(uint64_t partition, Addr addr, bool hit) override;
+};
+
+} // namespace partitioning_policy
+} // namespace gem5
+
+#endif // __MEM_CACHE_TAGS_PARTITIONING_POLICIES_UTILITY_PARTITIONING_HH__
@@ -0,0 +1,123 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "mem/cache/tags/partitioning_policies/way_partitioning.hh"
+
+#include "base/logging.hh"
+#include "base/trace.hh"
+#include "debug/CacheRepl.hh"
+#include "mem/cache/replacement_policies/replaceable_entry.hh"
+#include "params/WayPartitioningPolicy.hh"
+
+namespace gem5
+{
+
+namespace partitioning_policy
+{
+
+WayPartitioning::WayPartitioning(const Params &p)
+  : Base(p), wayMasks(p.way_masks), wayStats(*this)
+{
+    fatal_if(!wayMasks.empty() && wayMasks.size() != getNumPartitions(),
+             "%s has %d way masks for %d partitions\n", name(),
+             wayMasks.size(), getNumPartitions());
+    if (wayMasks.empty()) {
+        wayMasks.resize(getNumPartitions(), ~uint64_t(0));
+    }
+}
+
+void
+WayPartitioning::setGeometry(uint32_t num_sets, uint32_t num_ways,
+                             unsigned blk_size)
+{
+    Base::setGeometry(num_sets, num_ways, blk_size);
+
+    fatal_if(num_ways > 64, "%s cannot partition more than 64 ways\n",
+             name());
+    for (uint64_t partition = 0; partition < wayMasks.size(); partition++) {
+        wayMasks[partition] = checkMask(partition, wayMasks[partition]);
+    }
+}
+
+void
+WayPartitioning::filterCandidates(uint64_t partition,
+    const std::vector<ReplaceableEntry*> &entries,
+    std::vector<ReplaceableEntry*> &candidates) const
+{
+    const uint64_t mask = wayMasks[partition];
+    candidates.clear();
+    for (const auto entry : entries) {
+        if ((mask >> entry->getWay()) & 1) {
+            candidates.push_back(entry);
+        }
+    }
+    assert(!candidates.empty());
+}
+
+uint64_t
+WayPartitioning::checkMask(uint64_t partition, uint64_t mask) const
+{
+    fatal_if(partition >= getNumPartitions(),
+             "%s has no partition %d\n", name(), partition);
+
+    // Ignore the ways the cache does not have
+    if (assoc && assoc < 64) {
+        mask &= (uint64_t(1) << assoc) - 1;
+    }
+    fatal_if(mask == 0, "Partition %d of %s must have at least one way\n",
+             partition, name());
+    return mask;
+}
+
+void
+WayPartitioning::setWayMask(uint64_t partition, uint64_t mask)
+{
+    mask = checkMask(partition, mask);
+    if (wayMasks[partition] != mask) {
+        DPRINTF(CacheRepl, "%s: partition %d way mask %#x\n", name(),
+                partition, mask);
+        wayMasks[partition] = mask;
+        wayStats.maskChanges++;
+    }
+}
+
+uint64_t
+WayPartitioning::getWayMask(uint64_t partition) const
+{
+    fatal_if(partition >= getNumPartitions(),
+             "%s has no partition %d\n", name(), partition);
+    return wayMasks[partition];
+}
+
+WayPartitioning::WayPartitioningStats::WayPartitioningStats(
+    WayPartitioning &policy)
+  : statistics::Group(&policy),
+    ADD_STAT(maskChanges, statistics::units::Count::get(),
+             "Number of changes of the way mask of a partition")
+{
+}
+
+} // namespace partitioning_policy
+} // namespace gem5
@@ -0,0 +1,108 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** @file
+ * Declaration of a way partitioning policy, in which each partition may
+ * only allocate blocks in a subset of the ways of every set.
+ */
+
+#ifndef __MEM_CACHE_TAGS_PARTITIONING_POLICIES_WAY_PARTITIONING_HH__
+#define __MEM_CACHE_TAGS_PARTITIONING_POLICIES_WAY_PARTITIONING_HH__
+
+#include <cstdint>
+#include <vector>
+
+#include "mem/cache/tags/partitioning_policies/base.hh"
+
+namespace gem5
+{
+
+struct WayPartitioningPolicyParams;
+
+namespace partitioning_policy
+{
+
+/**
+ * Way partitioning, as in Intel's Cache Allocation Technology. Each
+ * partition has a mask of the ways it may allocate in, and masks may
+ * overlap. A partition still hits on blocks in any way, and it may
+ * victimize the blocks of other partitions within its ways. The masks can
+ * be changed while simulating.
+ */
+class WayPartitioning : public Base
+{
+  protected:
+    /** Mask of the allocatable ways of each partition. */
+    std::vector<uint64_t> wayMasks;
+
+    struct WayPartitioningStats : public statistics::Group
+    {
+        WayPartitioningStats(WayPartitioning &policy);
+
+        /** Number of times the mask of a partition was changed. */
+        statistics::Scalar maskChanges;
+    } wayStats;
+
+    /**
+     * Check that a partition exists, and that its mask has ways of the
+     * cache.
+     *
+     * @param partition The partition.
+     * @param mask Bit mask of the ways of the partition.
+     * @return The mask, without the ways the cache does not have.
+     */
+    uint64_t checkMask(uint64_t partition, uint64_t mask) const;
+
+  public:
+    typedef WayPartitioningPolicyParams Params;
+    WayPartitioning(const Params &p);
+
+    void setGeometry(uint32_t num_sets, uint32_t num_ways,
+                     unsigned blk_size) override;
+
+    void filterCandidates(uint64_t partition,
+        const std::vector<ReplaceableEntry*> &entries,
+        std::vector<ReplaceableEntry*> &candidates) const override;
+
+    /**
+     * Change the ways a partition may allocate in. Blocks already in other
+     * ways stay until they are victimized by the partitions owning them.
+     *
+     * @param partition The partition.
+     * @param mask Bit mask of the ways, which must not be empty.
+     */
+    void setWayMask(uint64_t partition, uint64_t mask);
+
+    /**
+     * @param partition The partition.
+     * @return Bit mask of the ways the partition may allocate in.
+     */
+    uint64_t getWayMask(uint64_t partition) const;
+};
+
+} // namespace partitioning_policy
+} // namespace gem5
+
+#endif // __MEM_CACHE_TAGS_PARTITIONING_POLICIES_WAY_PARTITIONING_HH__
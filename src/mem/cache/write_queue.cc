@@ -52,9 +52,10 @@ namespace gem5
 {
 
 WriteQueue::WriteQueue(const std::string &_label,
-                       int num_entries, int reserve, const std::string &name)
+                       int num_entries, int reserve, const std::string &name,
+                       bool indexed)
     : Queue<WriteQueueEntry>(_label, num_entries, reserve,
-            name + ".write_queue")
+            name + ".write_queue", indexed)
 {}
 
 WriteQueueEntry *
@@ -68,6 +69,7 @@ WriteQueue::allocate(Addr blk_addr, unsigned blk_size, PacketPtr pkt,
 
     entry->allocate(blk_addr, blk_size, pkt, when_ready, order);
     entry->allocIter = allocatedList.insert(allocatedList.end(), entry);
+    indexEntry(entry);
     entry->readyIter = addToReadyList(entry);
 
     allocated += 1;
@@ -305,6 +305,7 @@ CoherentXBar::recvTimingReq(PacketPtr pkt, PortID cpu_side_port_id)
     if (snoopFilter && snoop_caches) {
         // Let the snoop filter know about the success of the send operation
         snoopFilter->finishRequest(!success, addr, pkt->isSecure());
+        backInvalidate(true);
     }
 
     // check if we were successful in sending the packet onwards
@@ -724,6 +725,42 @@ CoherentXBar::forwardTiming(PacketPtr pkt, PortID exclude_cpu_side_port_id,
     snoopFanout.sample(fanout);
 }
 
+void
+CoherentXBar::backInvalidate(bool is_timing)
+{
+    SnoopFilter::Eviction eviction;
+    while (snoopFilter->takeEviction(eviction)) {
+        // the filter no longer tracks the line, so make sure no cache
+        // above keeps a copy. They evict it like any other line, so
+        // dirty copies are written back, and no response is expected.
+        Request::Flags flags = Request::INVALIDATE;
+        if (eviction.isSecure)
+            flags.set(Request::SECURE);
+        RequestPtr req = std::make_shared<Request>(eviction.addr,
+            system->cacheLineSize(), flags, Request::wbRequestorId);
+
+        DPRINTF(CoherentXBar, "%s: %#llx to %i holders\n", __func__,
+                eviction.addr, eviction.holders.size());
+
+        for (const auto& p: eviction.holders) {
+            Packet pkt(req, MemCmd::BackInvalidateReq);
+            if (is_timing) {
+                pkt.setExpressSnoop();
+                p->sendTimingSnoopReq(&pkt);
+                assert(!pkt.cacheResponding());
+
+                // a holder that is still evicting the line, e.g., with
+                // a writeback in its write buffer, may still supply the
+                // data until the eviction reaches us
+                if (pkt.isBlockCached())
+                    snoopFilter->trackEviction(eviction, *p);
+            } else {
+                p->sendAtomicSnoop(&pkt);
+            }
+        }
+    }
+}
+
 void
 CoherentXBar::recvReqRetry(PortID mem_side_port_id)
 {
@@ -772,6 +809,7 @@ CoherentXBar::recvAtomicBackdoor(PacketPtr pkt, PortID cpu_side_port_id,
             // avoid situations where atomic upward snoops sneak in
             // between and change the filter state
             snoopFilter->finishRequest(false, pkt->getAddr(), pkt->isSecure());
+            backInvalidate(false);
 
             if (pkt->isEviction()) {
                 // for block-evicting packets, i.e. writebacks and
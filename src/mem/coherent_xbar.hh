@@ -330,6 +330,17 @@ class CoherentXBar : public BaseXBar
     void forwardTiming(PacketPtr pkt, PortID exclude_cpu_side_port_id,
                        const std::vector<QueuedResponsePort*>& dests);
 
+    /**
+     * Invalidate the lines a set associative snoop filter evicted in
+     * the caches that hold them, as the filter no longer forwards
+     * snoops for them. The caches evict the lines as if they replaced
+     * them, and the filter keeps tracking those whose eviction is
+     * still in flight in timing mode.
+     *
+     * @param is_timing Whether to send timing or atomic snoops
+     */
+    void backInvalidate(bool is_timing);
+
     Tick recvAtomicBackdoor(PacketPtr pkt, PortID cpu_side_port_id,
                             MemBackdoorPtr *backdoor=nullptr);
     Tick recvAtomicSnoop(PacketPtr pkt, PortID mem_side_port_id);
@@ -233,6 +233,10 @@ MemCmd::commandInfo[] =
     { {IsRead, IsResponse}, InvalidCmd, "HTMReqResp" },
     { {IsRead, IsRequest}, InvalidCmd, "HTMAbort" },
     { {IsRequest}, InvalidCmd, "TlbiExtSync" },
+    /* Back-invalidation -- A snoop filter no longer tracks the block, and
+       the caches above must evict it. Dirty copies are written back as
+       on any eviction, so no response is expected. */
+    { {IsInvalidate, IsRequest}, InvalidCmd, "BackInvalidateReq" },
 };
 
 AddrRange
@@ -146,6 +146,8 @@ class MemCmd
         HTMAbort,
         // Tlb shootdown
         TlbiExtSync,
+        // Snoop filter eviction, see CoherentXBar::backInvalidate
+        BackInvalidateReq,
         NUM_MEM_CMDS
     };
 
@@ -218,6 +218,21 @@ addressOffset(Addr addr, Addr base)
     return offset;
 }
 
+// PC of the instruction behind a CPU request, 0 if it is unknown
+inline Addr
+requestPC(const RequestPtr &req)
+{
+    return req && req->hasPC() ? req->getPC() : 0;
+}
+
+// Context of the thread behind a CPU request, InvalidContextID if it is
+// unknown
+inline ContextID
+requestContext(const RequestPtr &req)
+{
+    return req && req->hasContextId() ? req->contextId() : InvalidContextID;
+}
+
 /**
  * This function accepts an address, a data block and a packet. If the address
  * range for the data block contains the address which the packet needs to
@@ -50,6 +50,7 @@
 #include "debug/RubyResourceStalls.hh"
 #include "debug/RubyStats.hh"
 #include "mem/cache/replacement_policies/weighted_lru_rp.hh"
+#include "mem/packet.hh"
 #include "mem/ruby/protocol/AccessPermission.hh"
 #include "mem/ruby/system/RubySystem.hh"
 
@@ -84,6 +85,7 @@ CacheMemory::CacheMemory(const Params &p)
     m_block_size = p.block_size;  // may be 0 at this point. Updated in init()
     m_use_occupancy = dynamic_cast<replacement_policy::WeightedLRU*>(
                                     m_replacementPolicy_ptr) ? true : false;
+    m_replacement_needs_packet = m_replacementPolicy_ptr->needsPacket();
 }
 
 void
@@ -105,7 +107,7 @@ CacheMemory::init()
     for (int i = 0; i < m_cache_num_sets; i++) {
         for ( int j = 0; j < m_cache_assoc; j++) {
             replacement_data[i][j] =
-                                m_replacementPolicy_ptr->instantiateEntry();
+                            m_replacementPolicy_ptr->instantiateEntry(i, j);
         }
     }
 }
@@ -190,8 +192,7 @@ CacheMemory::tryCacheAccess(Addr address, RubyRequestType type,
     AbstractCacheEntry* entry = lookup(address);
     if (entry != nullptr) {
         // Do we even have a tag match?
-        m_replacementPolicy_ptr->touch(entry->replacementData);
-        entry->setLastAccess(curTick());
+        touchEntry(entry);
         data_ptr = &(entry->getDataBlk());
 
         if (entry->m_Permission == AccessPermission_Read_Write) {
@@ -215,8 +216,7 @@ CacheMemory::testCacheAccess(Addr address, RubyRequestType type,
     AbstractCacheEntry* entry = lookup(address);
     if (entry != nullptr) {
         // Do we even have a tag match?
-        m_replacementPolicy_ptr->touch(entry->replacementData);
-        entry->setLastAccess(curTick());
+        touchEntry(entry);
         data_ptr = &(entry->getDataBlk());
 
         return entry->m_Permission != AccessPermission_NotPresent;
@@ -267,6 +267,20 @@ CacheMemory::cacheAvail(Addr address) const
 
 AbstractCacheEntry*
 CacheMemory::allocate(Addr address, AbstractCacheEntry *entry)
+{
+    return allocateEntry(address, entry, 0, InvalidContextID, false);
+}
+
+AbstractCacheEntry*
+CacheMemory::allocate(Addr address, AbstractCacheEntry *entry,
+                      ContextID context, Addr pc, bool prefetch)
+{
+    return allocateEntry(address, entry, pc, context, prefetch);
+}
+
+AbstractCacheEntry*
+CacheMemory::allocateEntry(Addr address, AbstractCacheEntry *entry,
+                           Addr pc, ContextID context, bool prefetch)
 {
     assert(address == makeLineAddress(address));
     assert(!isTagPresent(address));
@@ -294,11 +308,10 @@ CacheMemory::allocate(Addr address, AbstractCacheEntry *entry)
             m_tag_index[address] = i;
             set[i]->setPosition(cacheSet, i);
             set[i]->replacementData = replacement_data[cacheSet][i];
-            set[i]->setLastAccess(curTick());
 
             // Call reset function here to set initial value for different
             // replacement policies.
-            m_replacementPolicy_ptr->reset(entry->replacementData);
+            resetEntry(entry, pc, context, prefetch);
 
             return entry;
         }
@@ -365,8 +378,7 @@ CacheMemory::setMRU(Addr address)
 {
     AbstractCacheEntry* entry = lookup(makeLineAddress(address));
     if (entry != nullptr) {
-        m_replacementPolicy_ptr->touch(entry->replacementData);
-        entry->setLastAccess(curTick());
+        touchEntry(entry);
     }
 }
 
@@ -374,8 +386,16 @@ void
 CacheMemory::setMRU(AbstractCacheEntry *entry)
 {
     assert(entry != nullptr);
-    m_replacementPolicy_ptr->touch(entry->replacementData);
-    entry->setLastAccess(curTick());
+    touchEntry(entry);
+}
+
+void
+CacheMemory::setMRU(Addr address, ContextID context, Addr pc, bool prefetch)
+{
+    AbstractCacheEntry* entry = lookup(makeLineAddress(address));
+    if (entry != nullptr) {
+        touchEntry(entry, pc, context, prefetch);
+    }
 }
 
 void
@@ -390,13 +410,71 @@ CacheMemory::setMRU(Addr address, int occupancy)
             static_cast<replacement_policy::WeightedLRU*>(
                 m_replacementPolicy_ptr)->touch(
                 entry->replacementData, occupancy);
+            entry->setLastAccess(curTick());
         } else {
-            m_replacementPolicy_ptr->touch(entry->replacementData);
+            touchEntry(entry);
         }
-        entry->setLastAccess(curTick());
     }
 }
 
+PacketPtr
+CacheMemory::replacementPacket(Addr address, Addr pc, ContextID context,
+                               bool prefetch)
+{
+    if (!m_replacement_needs_packet) {
+        return nullptr;
+    }
+
+    const bool has_pc = pc != 0;
+    const bool has_context = context != InvalidContextID;
+    std::unique_ptr<Packet> &pkt =
+        m_replacement_packets[has_pc | has_context << 1];
+    if (!pkt) {
+        RequestPtr req = std::make_shared<Request>();
+        req->setPaddr(address);
+        pkt = std::make_unique<Packet>(req, MemCmd::ReadReq);
+    }
+
+    pkt->req->setPaddr(address);
+    pkt->setAddr(address);
+    if (has_pc) {
+        pkt->req->setPC(pc);
+    }
+    if (has_context) {
+        pkt->req->setContext(context);
+    }
+    pkt->cmd = prefetch ? MemCmd::HardPFReq : MemCmd::ReadReq;
+    return pkt.get();
+}
+
+void
+CacheMemory::touchEntry(AbstractCacheEntry *entry, Addr pc,
+                        ContextID context, bool prefetch)
+{
+    PacketPtr pkt = replacementPacket(entry->m_Address, pc, context,
+                                      prefetch);
+    if (pkt) {
+        m_replacementPolicy_ptr->touch(entry->replacementData, pkt);
+    } else {
+        m_replacementPolicy_ptr->touch(entry->replacementData);
+    }
+    entry->setLastAccess(curTick());
+}
+
+void
+CacheMemory::resetEntry(AbstractCacheEntry *entry, Addr pc,
+                        ContextID context, bool prefetch)
+{
+    PacketPtr pkt = replacementPacket(entry->m_Address, pc, context,
+                                      prefetch);
+    if (pkt) {
+        m_replacementPolicy_ptr->reset(entry->replacementData, pkt);
+    } else {
+        m_replacementPolicy_ptr->reset(entry->replacementData);
+    }
+    entry->setLastAccess(curTick());
+}
+
 int
 CacheMemory::getReplacementWeight(int64_t set, int64_t loc)
 {
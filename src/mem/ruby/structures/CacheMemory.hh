@@ -42,6 +42,8 @@
 #ifndef __MEM_RUBY_STRUCTURES_CACHEMEMORY_HH__
 #define __MEM_RUBY_STRUCTURES_CACHEMEMORY_HH__
 
+#include <array>
+#include <memory>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -49,6 +51,7 @@
 #include "base/statistics.hh"
 #include "mem/cache/replacement_policies/base.hh"
 #include "mem/cache/replacement_policies/replaceable_entry.hh"
+#include "mem/packet.hh"
 #include "mem/ruby/common/DataBlock.hh"
 #include "mem/ruby/protocol/CacheRequestType.hh"
 #include "mem/ruby/protocol/CacheResourceType.hh"
@@ -102,6 +105,12 @@ class CacheMemory : public SimObject
 
     // find an unused entry and sets the tag appropriate for the address
     AbstractCacheEntry* allocate(Addr address, AbstractCacheEntry* new_entry);
+    // as above, telling the replacement policy about the access that
+    // brought the block in: the context of the CPU request behind it
+    // (InvalidContextID if unknown), its PC (0 if unknown), and whether
+    // it is a prefetch
+    AbstractCacheEntry* allocate(Addr address, AbstractCacheEntry* new_entry,
+                                 ContextID context, Addr pc, bool prefetch);
     void allocateVoid(Addr address, AbstractCacheEntry* new_entry)
     {
         allocate(address, new_entry);
@@ -130,6 +139,12 @@ class CacheMemory : public SimObject
     void setMRU(Addr address);
     void setMRU(Addr addr, int occupancy);
     void setMRU(AbstractCacheEntry* entry);
+    // Set this address to most recently used on behalf of an access, so
+    // that policies learning from the access stream (e.g. Hawkeye, SHiP)
+    // can attribute it to a core and PC, and tell prefetches apart. The
+    // context is that of the CPU request behind the access, as Ruby
+    // machine IDs do not map to cores.
+    void setMRU(Addr address, ContextID context, Addr pc, bool prefetch);
     int getReplacementWeight(int64_t set, int64_t loc);
 
     // Functions for locking and unlocking cache lines corresponding to the
@@ -168,6 +183,25 @@ class CacheMemory : public SimObject
     int findTagInSet(int64_t line, Addr tag) const;
     int findTagInSetIgnorePermissions(int64_t cacheSet, Addr tag) const;
 
+    /**
+     * Ruby has no packet at hand when it updates the replacement state, so
+     * fill one carrying whatever access context the protocol supplied.
+     * An unknown pc is 0 and an unknown context is InvalidContextID.
+     * Prefetches are hardware prefetch requests, other accesses are reads.
+     * Returns nullptr if the policy does not use packets.
+     */
+    PacketPtr replacementPacket(Addr address, Addr pc, ContextID context,
+                                bool prefetch);
+    void touchEntry(AbstractCacheEntry* entry, Addr pc = 0,
+                    ContextID context = InvalidContextID,
+                    bool prefetch = false);
+    void resetEntry(AbstractCacheEntry* entry, Addr pc = 0,
+                    ContextID context = InvalidContextID,
+                    bool prefetch = false);
+    AbstractCacheEntry* allocateEntry(Addr address, AbstractCacheEntry* entry,
+                                      Addr pc, ContextID context,
+                                      bool prefetch);
+
     // Private copy constructor and assignment operator
     CacheMemory(const CacheMemory& obj);
     CacheMemory& operator=(const CacheMemory& obj);
@@ -211,6 +245,15 @@ class CacheMemory : public SimObject
      */
     bool m_use_occupancy;
 
+    /** Set if the replacement policy learns from the access packets. */
+    bool m_replacement_needs_packet;
+
+    /**
+     * Packets reused by replacementPacket(), one for each combination of
+     * known pc and context, since these cannot be unset in a request.
+     */
+    std::array<std::unique_ptr<Packet>, 4> m_replacement_packets;
+
     private:
       struct CacheMemoryStats : public statistics::Group
       {
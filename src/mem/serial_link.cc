@@ -50,6 +50,7 @@
 #include "base/trace.hh"
 #include "debug/SerialLink.hh"
 #include "params/SerialLink.hh"
+#include "sim/simulate.hh"
 
 namespace gem5
 {
@@ -113,6 +114,19 @@ SerialLink::init()
 
     // notify the request side  of our address ranges
     cpu_side_port.sendRangeChange();
+
+    // Requests and responses that reach the serial link are only forwarded
+    // after its delay, which is the lookahead from the queues of the
+    // peers to ours
+    const Tick latency = cyclesToTicks(ticksToCycles(params().delay));
+    if (latency) {
+        auto &cpu_side = static_cast<RequestPort &>(cpu_side_port.getPeer());
+        auto &mem_side = static_cast<ResponsePort &>(mem_side_port.getPeer());
+        declareLookahead(cpu_side.getOwner().eventQueue(), eventQueue(),
+                         latency);
+        declareLookahead(mem_side.getOwner().eventQueue(), eventQueue(),
+                         latency);
+    }
 }
 
 bool
@@ -320,7 +320,7 @@ class SerialLink : public ClockedObject
 
     virtual void init();
 
-    typedef SerialLinkParams Params;
+    PARAMS(SerialLink);
 
     SerialLink(const SerialLinkParams &p);
 };
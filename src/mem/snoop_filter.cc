@@ -42,6 +42,7 @@
 
 #include "mem/snoop_filter.hh"
 
+#include "base/intmath.hh"
 #include "base/logging.hh"
 #include "base/trace.hh"
 #include "debug/SnoopFilter.hh"
@@ -51,18 +52,156 @@ namespace gem5
 {
 
 const int SnoopFilter::SNOOP_MASK_SIZE;
+const Addr SnoopFilter::InvalidLine;
+
+SnoopFilter::SnoopFilter(const SnoopFilterParams &p)
+    : SimObject(p), assoc(p.assoc),
+      numSets(p.assoc ?
+          p.max_capacity / p.system->cacheLineSize() / p.assoc : 0),
+      lineShift(floorLog2(p.system->cacheLineSize())),
+      lineAddrs(numSets * assoc, InvalidLine), items(numSets * assoc),
+      lastUse(numSets * assoc, 0), numValid(0), useCount(0),
+      evictionPending(false),
+      linesize(p.system->cacheLineSize()), lookupLatency(p.lookup_latency),
+      maxEntryCount(p.max_capacity / p.system->cacheLineSize()),
+      stats(this)
+{
+    fatal_if(assoc && !isPowerOf2(numSets),
+             "The number of sets of snoop filter %s must be a non-zero "
+             "power of 2, got %d\n", name(), numSets);
+}
+
+SnoopFilter::SnoopItem*
+SnoopFilter::findItem(Addr line_addr)
+{
+    if (!assoc) {
+        auto sf_it = cachedLocations.find(line_addr);
+        return (sf_it != cachedLocations.end()) ? &sf_it->second : nullptr;
+    }
+
+    const std::size_t first = ((line_addr >> lineShift) & (numSets - 1)) *
+        assoc;
+    for (std::size_t entry = first; entry < first + assoc; entry++) {
+        if (lineAddrs[entry] == line_addr) {
+            lastUse[entry] = ++useCount;
+            return &items[entry];
+        }
+    }
+
+    if (evictedLines.empty())
+        return nullptr;
+    auto sf_it = evictedLines.find(line_addr);
+    return (sf_it != evictedLines.end()) ? &sf_it->second : nullptr;
+}
+
+SnoopFilter::SnoopItem*
+SnoopFilter::allocateItem(Addr line_addr)
+{
+    if (!assoc) {
+        return &cachedLocations.emplace(line_addr, SnoopItem()).first->second;
+    }
+
+    // Prefer an unused entry. Otherwise evict the least recently used line
+    // that does not have requests in flight, as their responses must find
+    // the entry
+    const std::size_t first = ((line_addr >> lineShift) & (numSets - 1)) *
+        assoc;
+    std::size_t victim = first + assoc;
+    for (std::size_t entry = first; entry < first + assoc; entry++) {
+        if (lineAddrs[entry] == InvalidLine) {
+            victim = entry;
+            break;
+        }
+        if (items[entry].requested.none() &&
+            (victim == first + assoc || lastUse[entry] < lastUse[victim])) {
+            victim = entry;
+        }
+    }
+    panic_if(victim == first + assoc, "All the lines of a set of snoop "
+             "filter %s have requests in flight, increase its "
+             "associativity\n", name());
+
+    if (lineAddrs[victim] != InvalidLine) {
+        // The caller must back-invalidate the line in its holders, as the
+        // filter will no longer forward snoops to them
+        assert(!evictionPending);
+        const Addr victim_addr = lineAddrs[victim];
+        lastEviction.addr = victim_addr & ~Addr(LineSecure);
+        lastEviction.isSecure = victim_addr & LineSecure;
+        lastEviction.holders = maskToPortList(items[victim].holder);
+        evictionPending = !lastEviction.holders.empty();
+
+        stats.evictions++;
+        stats.backInvalidations += lastEviction.holders.size();
+        DPRINTF(SnoopFilter, "%s:   evicted %#llx SF value %x.%x\n",
+                __func__, victim_addr, items[victim].requested,
+                items[victim].holder);
+    } else {
+        numValid++;
+    }
+
+    lineAddrs[victim] = line_addr;
+    items[victim] = SnoopItem();
+    lastUse[victim] = ++useCount;
+    return &items[victim];
+}
 
 void
-SnoopFilter::eraseIfNullEntry(SnoopFilterCache::iterator& sf_it)
+SnoopFilter::eraseIfNullEntry(Addr line_addr, SnoopItem* sf_item)
 {
-    SnoopItem& sf_item = sf_it->second;
-    if ((sf_item.requested | sf_item.holder).none()) {
-        cachedLocations.erase(sf_it);
+    if ((sf_item->requested | sf_item->holder).none()) {
+        if (!assoc) {
+            cachedLocations.erase(line_addr);
+        } else if (isEvicted(sf_item)) {
+            evictedLines.erase(line_addr);
+        } else {
+            const std::size_t entry = sf_item - items.data();
+            assert(lineAddrs[entry] == line_addr);
+            lineAddrs[entry] = InvalidLine;
+            numValid--;
+        }
         DPRINTF(SnoopFilter, "%s:   Removed SF entry.\n",
                 __func__);
     }
 }
 
+std::size_t
+SnoopFilter::numItems() const
+{
+    return assoc ? numValid : cachedLocations.size();
+}
+
+bool
+SnoopFilter::takeEviction(Eviction& eviction)
+{
+    if (!evictionPending) {
+        return false;
+    }
+    eviction = std::move(lastEviction);
+    evictionPending = false;
+    return true;
+}
+
+void
+SnoopFilter::trackEviction(const Eviction& eviction,
+                           const ResponsePort& holder)
+{
+    Addr line_addr = eviction.addr;
+    if (eviction.isSecure) {
+        line_addr |= LineSecure;
+    }
+    // The line was just evicted from its set, and the caller did not
+    // let any request in since
+    SnoopItem& sf_item = evictedLines[line_addr];
+    assert(isEvicted(&sf_item));
+    sf_item.holder |= portToMask(holder);
+    stats.evictionsInFlight++;
+
+    DPRINTF(SnoopFilter, "%s: %#llx in flight from %s, SF value %x.%x\n",
+            __func__, line_addr, holder.name(), sf_item.requested,
+            sf_item.holder);
+}
+
 std::pair<SnoopFilter::SnoopList, Cycles>
 SnoopFilter::lookupRequest(const Packet* cpkt, const ResponsePort&
                            cpu_side_port)
@@ -78,21 +217,31 @@ SnoopFilter::lookupRequest(const Packet* cpkt, const ResponsePort&
         line_addr |= LineSecure;
     }
     SnoopMask req_port = portToMask(cpu_side_port);
-    reqLookupResult.it = cachedLocations.find(line_addr);
-    bool is_hit = (reqLookupResult.it != cachedLocations.end());
+    reqLookupResult.lineAddr = line_addr;
+    reqLookupResult.item = findItem(line_addr);
+    bool is_hit = (reqLookupResult.item != nullptr);
 
     // If the snoop filter has no entry, and we should not allocate,
     // do not create a new snoop filter entry, simply return a NULL
-    // portlist.
-    if (!is_hit && !allocate)
+    // portlist. A set associative filter may have evicted, and
+    // back-invalidated, the line being evicted by the request, so there
+    // is nothing to track either.
+    if (!is_hit && (!allocate || (assoc && cpkt->isEviction())))
         return snoopDown(lookupLatency);
 
-    // If no hit in snoop filter create a new element and update iterator
+    // If no hit in snoop filter create a new element. A line that is
+    // requested again while its holders are still evicting it moves back
+    // to its set, so that the eviction buffer only keeps transient lines
     if (!is_hit) {
-        reqLookupResult.it =
-            cachedLocations.emplace(line_addr, SnoopItem()).first;
+        reqLookupResult.item = allocateItem(line_addr);
+    } else if (assoc && allocate && !cpkt->isEviction() &&
+               isEvicted(reqLookupResult.item)) {
+        const SnoopItem evicted = *reqLookupResult.item;
+        evictedLines.erase(line_addr);
+        reqLookupResult.item = allocateItem(line_addr);
+        *reqLookupResult.item = evicted;
     }
-    SnoopItem& sf_item = reqLookupResult.it->second;
+    SnoopItem& sf_item = *reqLookupResult.item;
     SnoopMask interested = sf_item.holder | sf_item.requested;
 
     // Store unmodified value of snoop filter item in temp storage in
@@ -159,26 +308,27 @@ SnoopFilter::lookupRequest(const Packet* cpkt, const ResponsePort&
 void
 SnoopFilter::finishRequest(bool will_retry, Addr addr, bool is_secure)
 {
-    if (reqLookupResult.it != cachedLocations.end()) {
+    if (reqLookupResult.item) {
         // since we rely on the caller, do a basic check to ensure
         // that finishRequest is being called following lookupRequest
         Addr line_addr = (addr & ~(Addr(linesize - 1)));
         if (is_secure) {
             line_addr |= LineSecure;
         }
-        assert(reqLookupResult.it->first == line_addr);
+        assert(reqLookupResult.lineAddr == line_addr);
         if (will_retry) {
             SnoopItem retry_item = reqLookupResult.retryItem;
             // Undo any changes made in lookupRequest to the snoop filter
             // entry if the request will come again. retryItem holds
             // the previous value of the snoopfilter entry.
-            reqLookupResult.it->second = retry_item;
+            *reqLookupResult.item = retry_item;
 
             DPRINTF(SnoopFilter, "%s:   restored SF value %x.%x\n",
                     __func__,  retry_item.requested, retry_item.holder);
         }
 
-        eraseIfNullEntry(reqLookupResult.it);
+        eraseIfNullEntry(line_addr, reqLookupResult.item);
+        reqLookupResult.item = nullptr;
     }
 }
 
@@ -193,10 +343,11 @@ SnoopFilter::lookupSnoop(const Packet* cpkt)
     if (cpkt->isSecure()) {
         line_addr |= LineSecure;
     }
-    auto sf_it = cachedLocations.find(line_addr);
-    bool is_hit = (sf_it != cachedLocations.end());
+    SnoopItem* const sf_it = findItem(line_addr);
+    bool is_hit = (sf_it != nullptr);
 
-    panic_if(!is_hit && (cachedLocations.size() >= maxEntryCount),
+    // A set associative filter is normally full, and cannot overflow
+    panic_if(!assoc && !is_hit && (numItems() >= maxEntryCount),
              "snoop filter exceeded capacity of %d cache blocks\n",
              maxEntryCount);
 
@@ -206,7 +357,7 @@ SnoopFilter::lookupSnoop(const Packet* cpkt)
     if (!is_hit)
         return snoopDown(lookupLatency);
 
-    SnoopItem& sf_item = sf_it->second;
+    SnoopItem& sf_item = *sf_it;
 
     SnoopMask interested = (sf_item.holder | sf_item.requested);
 
@@ -236,7 +387,7 @@ SnoopFilter::lookupSnoop(const Packet* cpkt)
         sf_item.holder = 0;
         DPRINTF(SnoopFilter, "%s:   new SF value %x.%x\n",
                 __func__, sf_item.requested, sf_item.holder);
-        eraseIfNullEntry(sf_it);
+        eraseIfNullEntry(line_addr, sf_it);
     }
 
     return snoopSelected(maskToPortList(interested), lookupLatency);
@@ -266,7 +417,11 @@ SnoopFilter::updateSnoopResponse(const Packet* cpkt,
     }
     SnoopMask rsp_mask = portToMask(rsp_port);
     SnoopMask req_mask = portToMask(req_port);
-    SnoopItem& sf_item = cachedLocations[line_addr];
+    SnoopItem* const sf_it = findItem(line_addr);
+
+    // The line has a request in flight, so it cannot have been evicted
+    panic_if(!sf_it, "SF has no entry for %#llx\n", line_addr);
+    SnoopItem& sf_item = *sf_it;
 
     DPRINTF(SnoopFilter, "%s:   old SF value %x.%x\n",
             __func__,  sf_item.requested, sf_item.holder);
@@ -313,8 +468,8 @@ SnoopFilter::updateSnoopForward(const Packet* cpkt,
     if (cpkt->isSecure()) {
         line_addr |= LineSecure;
     }
-    auto sf_it = cachedLocations.find(line_addr);
-    bool is_hit = sf_it != cachedLocations.end();
+    SnoopItem* const sf_it = findItem(line_addr);
+    bool is_hit = sf_it != nullptr;
 
     // Nothing to do if it is not a hit
     if (!is_hit)
@@ -324,7 +479,7 @@ SnoopFilter::updateSnoopForward(const Packet* cpkt,
     // Modified state, and we know that there are no other copies, or
     // they will all be invalidated imminently
     if (!cpkt->hasSharers()) {
-        SnoopItem& sf_item = sf_it->second;
+        SnoopItem& sf_item = *sf_it;
 
         DPRINTF(SnoopFilter, "%s:   old SF value %x.%x\n",
                 __func__, sf_item.requested, sf_item.holder);
@@ -332,7 +487,7 @@ SnoopFilter::updateSnoopForward(const Packet* cpkt,
         DPRINTF(SnoopFilter, "%s:   new SF value %x.%x\n",
                 __func__, sf_item.requested, sf_item.holder);
 
-        eraseIfNullEntry(sf_it);
+        eraseIfNullEntry(line_addr, sf_it);
     }
 }
 
@@ -355,12 +510,12 @@ SnoopFilter::updateResponse(const Packet* cpkt, const ResponsePort&
     if (cpkt->isSecure()) {
         line_addr |= LineSecure;
     }
-    auto sf_it = cachedLocations.find(line_addr);
-    if (sf_it == cachedLocations.end())
+    SnoopItem* const sf_it = findItem(line_addr);
+    if (!sf_it)
         return;
 
     SnoopMask response_mask = portToMask(cpu_side_port);
-    SnoopItem& sf_item = sf_it->second;
+    SnoopItem& sf_item = *sf_it;
 
     DPRINTF(SnoopFilter, "%s:   old SF value %x.%x\n",
             __func__,  sf_item.requested, sf_item.holder);
@@ -379,7 +534,7 @@ SnoopFilter::updateResponse(const Packet* cpkt, const ResponsePort&
         if (cpkt->isInvalidate()) {
             sf_item.holder &= ~response_mask;
         }
-        eraseIfNullEntry(sf_it);
+        eraseIfNullEntry(line_addr, sf_it);
     } else {
         // Any other response implies that a cache above will have the
         // block.
@@ -407,7 +562,16 @@ SnoopFilter::SnoopFilterStats::SnoopFilterStats(statistics::Group *parent)
                "holder of the requested data."),
       ADD_STAT(hitMultiSnoops, statistics::units::Count::get(),
                "Number of snoops hitting in the snoop filter with multiple "
-               "(>1) holders of the requested data.")
+               "(>1) holders of the requested data."),
+      ADD_STAT(evictions, statistics::units::Count::get(),
+               "Number of lines evicted from a set associative snoop "
+               "filter to make room for other lines."),
+      ADD_STAT(backInvalidations, statistics::units::Count::get(),
+               "Number of holders an evicted line was back-invalidated "
+               "in."),
+      ADD_STAT(evictionsInFlight, statistics::units::Count::get(),
+               "Number of back-invalidated holders that were still "
+               "evicting the line, and stayed tracked until they did.")
 {}
 
 void
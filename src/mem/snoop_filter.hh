@@ -46,6 +46,7 @@
 #include <bitset>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include "mem/packet.hh"
 #include "mem/port.hh"
@@ -85,6 +86,16 @@ namespace gem5
  *     upper cache dropped a line, making the snoop filter pessimistic for now
  * (4) ordering: there is no single point of order in the system.  Instead,
  *     requesting MSHRs track order between local requests and remote snoops
+ *
+ * By default the filter tracks any number of lines, up to a sanity limit.
+ * It can instead be given an associativity, in which case its entries are
+ * kept in a flat set associative table, like a hardware snoop filter. When
+ * a set is full, the least recently used line without outstanding requests
+ * is evicted, and the crossbar back-invalidates it in the caches that hold
+ * it (see takeEviction). The holders evict the line as if they replaced
+ * it, and those whose eviction is still in flight stay tracked in an
+ * eviction buffer until it reaches the filter (see trackEviction), as
+ * they may still supply the data.
  */
 class SnoopFilter : public SimObject
 {
@@ -95,13 +106,20 @@ class SnoopFilter : public SimObject
 
     typedef std::vector<QueuedResponsePort*> SnoopList;
 
-    SnoopFilter (const SnoopFilterParams &p) :
-        SimObject(p), reqLookupResult(cachedLocations.end()),
-        linesize(p.system->cacheLineSize()), lookupLatency(p.lookup_latency),
-        maxEntryCount(p.max_capacity / p.system->cacheLineSize()),
-        stats(this)
+    /** A line evicted from the filter to make room for another one. */
+    struct Eviction
     {
-    }
+        /** Address of the line. */
+        Addr addr;
+
+        /** Whether the line belongs to the secure memory space. */
+        bool isSecure;
+
+        /** Ports that hold the line, and must invalidate it. */
+        SnoopList holders;
+    };
+
+    SnoopFilter(const SnoopFilterParams &p);
 
     /**
      * Init a new snoop filter and tell it about all the cpu_sideports
@@ -200,6 +218,26 @@ class SnoopFilter : public SimObject
      */
     void updateResponse(const Packet *cpkt, const ResponsePort& cpu_side_port);
 
+    /**
+     * Get the line evicted by the last request lookup, if any. The line is
+     * no longer tracked, so the caller must back-invalidate it in all its
+     * holders. Only a set associative filter evicts lines.
+     *
+     * @param eviction Filled with the evicted line, if any.
+     * @return Whether a line was evicted since the last call.
+     */
+    bool takeEviction(Eviction& eviction);
+
+    /**
+     * Keep tracking a holder of an evicted line until its own eviction of
+     * the line reaches the filter, as its writeback may still be in
+     * flight when it is back-invalidated.
+     *
+     * @param eviction The evicted line.
+     * @param holder The holder that has not evicted the line yet.
+     */
+    void trackEviction(const Eviction& eviction, const ResponsePort& holder);
+
     virtual void regStats();
 
   protected:
@@ -258,14 +296,90 @@ class SnoopFilter : public SimObject
 
   private:
 
+    /**
+     * Find the item of a line.
+     *
+     * @param line_addr Line address, including the secure bit.
+     * @return The item, or nullptr if the line is not tracked.
+     */
+    SnoopItem* findItem(Addr line_addr);
+
+    /**
+     * Start tracking a line. If the filter is set associative and the set
+     * of the line is full, another line is evicted (see takeEviction).
+     *
+     * @param line_addr Line address, including the secure bit.
+     * @return The new, empty, item.
+     */
+    SnoopItem* allocateItem(Addr line_addr);
+
     /**
      * Removes snoop filter items which have no requestors and no holders.
+     *
+     * @param line_addr Line address, including the secure bit.
+     * @param sf_item The item of the line.
      */
-    void eraseIfNullEntry(SnoopFilterCache::iterator& sf_it);
+    void eraseIfNullEntry(Addr line_addr, SnoopItem* sf_item);
+
+    /** Number of lines tracked. */
+    std::size_t numItems() const;
 
-    /** Simple hash set of cached addresses. */
+    /** @return Whether an item is in the eviction buffer. */
+    bool
+    isEvicted(const SnoopItem* sf_item) const
+    {
+        return sf_item < items.data() ||
+            sf_item >= items.data() + items.size();
+    }
+
+    /** Simple hash set of cached addresses, when not set associative. */
     SnoopFilterCache cachedLocations;
 
+    /**
+     * Associativity of the filter. If 0 the filter is not set
+     * associative, and the lines are kept in cachedLocations.
+     */
+    const unsigned assoc;
+
+    /** Number of sets of a set associative filter. */
+    const unsigned numSets;
+
+    /** Log2 of the cache line size, to index the sets. */
+    const unsigned lineShift;
+
+    /**
+     * Line addresses of the entries of a set associative filter, set by
+     * set, or InvalidLine if the entry is not in use. They are kept apart
+     * from the items so that a lookup only walks a few contiguous words.
+     */
+    std::vector<Addr> lineAddrs;
+
+    /** Items of the entries of a set associative filter. */
+    std::vector<SnoopItem> items;
+
+    /** Last use of the entries of a set associative filter, for LRU. */
+    std::vector<uint64_t> lastUse;
+
+    /** Number of entries of a set associative filter in use. */
+    std::size_t numValid;
+
+    /** Timestamp of the entry accesses. */
+    uint64_t useCount;
+
+    /** Marks an unused entry; line addresses never have these bits set. */
+    static const Addr InvalidLine = MaxAddr;
+
+    /**
+     * Lines evicted from a set associative filter whose holders still have
+     * their own eviction in flight, see trackEviction. A line is either in
+     * a set or here.
+     */
+    SnoopFilterCache evictedLines;
+
+    /** Line evicted by the last request lookup, if evictionPending. */
+    Eviction lastEviction;
+    bool evictionPending;
+
     /**
      * A request lookup must be followed by a call to finishRequest to inform
      * the operation's success. If a retry is needed, however, all changes
@@ -274,8 +388,11 @@ class SnoopFilter : public SimObject
      */
     struct ReqLookupResult
     {
-        /** Iterator used to store the result from lookupRequest. */
-        SnoopFilterCache::iterator it;
+        /** Line address of the item found or allocated by lookupRequest. */
+        Addr lineAddr;
+
+        /** Item found or allocated by lookupRequest, if any. */
+        SnoopItem* item;
 
         /**
          * Variable to temporarily store value of snoopfilter entry
@@ -284,17 +401,10 @@ class SnoopFilter : public SimObject
          */
         SnoopItem retryItem;
 
-        /**
-         * The constructor must be informed of the internal cache's end
-         * iterator, so do not allow the compiler to implictly define it.
-         *
-         * @param end_it Iterator to the end of the internal cache.
-         */
-        ReqLookupResult(SnoopFilterCache::iterator end_it)
-            : it(end_it), retryItem{0, 0}
+        ReqLookupResult()
+            : lineAddr(0), item(nullptr), retryItem{0, 0}
         {
         }
-        ReqLookupResult() = delete;
     } reqLookupResult;
 
     /** List of all attached snooping CPU-side ports. */
@@ -329,6 +439,10 @@ class SnoopFilter : public SimObject
         statistics::Scalar totSnoops;
         statistics::Scalar hitSingleSnoops;
         statistics::Scalar hitMultiSnoops;
+
+        statistics::Scalar evictions;
+        statistics::Scalar backInvalidations;
+        statistics::Scalar evictionsInFlight;
     } stats;
 };
 
@@ -146,6 +146,22 @@ def parse_options():
               " to be compressed automatically [Default: %default]")
     option("--debug-ignore", metavar="EXPR", action='append', split=':',
         help="Ignore EXPR sim objects")
+    option("--event-pool-stats", metavar="FILE", default=None,
+        help="Count the deleted managed events per description and write"
+             " the event pool usage to FILE at exit")
+    option("--eventq-profile", metavar="N", type='int', default=0,
+        help="Count the events of every object and partition the objects"
+             " over N event queues, writing eventq_assignment.json to the"
+             " output directory at exit")
+    option("--host-profile", metavar="FILE", default=None,
+        help="Sample the host time spent servicing events and write it per"
+             " event, object and event type to FILE at exit")
+    option("--host-profile-interval", metavar="N", type='int', default=64,
+        help="Time one in about N events when profiling the host time"
+             " [Default: %default]")
+    option("--eventq-assignment", metavar="FILE", default=None,
+        help="Assign the objects to the event queues listed in FILE, as"
+             " written by --eventq-profile")
     option("--remote-gdb-port", type='int', default=7000,
         help="Remote gdb base port (set to 0 to disable listening)")
 
@@ -402,6 +418,25 @@ def main():
         _check_tracing()
         trace.ignore(ignore)
 
+    if options.eventq_profile:
+        import atexit
+        from .util import eventq_partition
+        event.profileEvents(True)
+        atexit.register(eventq_partition.dump, options.outdir,
+                        options.eventq_profile)
+
+    if options.host_profile:
+        import atexit
+        from .util import host_profile
+        event.profileHostTime(options.host_profile_interval)
+        atexit.register(host_profile.dump, options.outdir,
+                        options.host_profile)
+
+    if options.event_pool_stats:
+        import atexit
+        event.trackEventPool(True)
+        atexit.register(event.dumpEventPool, options.event_pool_stats)
+
     sys.argv = arguments
     sys.path = [ os.path.dirname(sys.argv[0]) ] + sys.path
 
@@ -80,6 +80,10 @@ def instantiate(ckpt_dir=None):
     if not root:
         fatal("Need to instantiate Root() before calling instantiate()")
 
+    if options.eventq_assignment:
+        from .util import eventq_partition
+        eventq_partition.apply(root, options.eventq_assignment)
+
     # we need to fix the global frequency
     ticks.fixGlobalFrequency()
 
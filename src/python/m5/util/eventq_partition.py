@@ -0,0 +1,280 @@
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+"""Partitioning of the SimObjects of a configuration over event queues.
+
+A profiling run counts the events serviced on behalf of every SimObject
+(see EventQueue::profile()). Together with the port connections, this
+gives a weighted communication graph, which is split into balanced parts
+with few connections between them. Every part is then assigned an event
+queue, and thus a thread, through the eventq_index of its objects.
+
+A port connection between two objects on different event queues is only
+safe through a link object, which delays the packets crossing it by at
+least the quantum the queues synchronize at. Any other connection makes
+direct port calls into the other queue, which race with its thread
+whatever the latency of the objects involved, so it is never cut.
+"""
+
+import json
+import os
+
+# Objects delaying every packet that crosses them. They declare their
+# delay as the lookahead between the queues on either side, see
+# declareLookahead(), so the graph may only be cut at them.
+link_types = ('Bridge', 'SerialLink')
+
+def is_link(objects, src, dst):
+    """Whether the connection from src to dst goes through a link."""
+    return objects[src]['type'] in link_types or \
+        objects[dst]['type'] in link_types
+
+def build_profile(root, event_counts):
+    """Build the communication graph of the objects below root.
+
+    event_counts maps event names to the number of times they were
+    serviced. Event names start with the path of their object, the
+    events that match no object are accounted to root.
+    """
+    objects = {}
+    for obj in root.descendants():
+        parent = obj.get_parent()
+        connected = False
+        for ref in obj._port_refs.values():
+            refs = ref.elements if hasattr(ref, 'elements') else [ref]
+            connected |= any(r.peer is not None for r in refs)
+        objects[obj.path()] = {
+            'type': obj.type,
+            'parent': parent.path() if parent is not None else None,
+            'connected': connected,
+            'events': 0,
+        }
+
+    for name, count in event_counts.items():
+        path = name
+        while path and path not in objects:
+            path = path.rpartition('.')[0]
+        objects[path if path else root.path()]['events'] += count
+
+    links = {}
+    for obj in root.descendants():
+        for ref in obj._port_refs.values():
+            refs = ref.elements if hasattr(ref, 'elements') else [ref]
+            for r in refs:
+                if r.peer is None or not r.is_source:
+                    continue
+                key = (obj.path(), r.peer.simobj.path())
+                links[key] = links.get(key, 0) + 1
+
+    return {
+        'root': root.path(),
+        'objects': objects,
+        'links': [ [src, dst, n] for (src, dst), n in sorted(links.items()) ],
+    }
+
+def partition(profile, num_queues, imbalance=0.1):
+    """Assign the objects of a profile to num_queues event queues.
+
+    Objects without connected ports are kept with their parent, since
+    they interact with it through direct calls, and objects connected
+    other than through a link are kept together, so that only
+    connections through links are cut. Each queue is then grown
+    from the heaviest remaining group by adding the groups the most
+    connected to it, until it holds its share of the events. Finally,
+    groups are moved between queues as long as this reduces the cost of
+    the cut connections without loading any queue by more than
+    (1 + imbalance) times the average. Root always runs on queue 0.
+
+    Returns a dict mapping object paths to event queue indices.
+    """
+    objects = profile['objects']
+    root = profile['root']
+
+    def group_of(path):
+        while path != root and not objects[path]['connected'] and \
+              objects[path]['parent'] is not None:
+            path = objects[path]['parent']
+        return path
+
+    groups = { path: group_of(path) for path in objects }
+
+    # Merge the groups connected directly
+    merged = { group: group for group in groups.values() }
+    def find(group):
+        while merged[group] != group:
+            merged[group] = merged[merged[group]]
+            group = merged[group]
+        return group
+
+    for src, dst, n in profile['links']:
+        if not is_link(objects, src, dst):
+            a, b = find(groups[src]), find(groups[dst])
+            if a != b:
+                merged[max(a, b)] = min(a, b)
+    groups = { path: find(group) for path, group in groups.items() }
+
+    weight = {}
+    for path, group in groups.items():
+        weight[group] = weight.get(group, 0) + objects[path]['events'] + 1
+
+    # Connection costs between groups, which are all through links
+    adjacency = { group: {} for group in weight }
+    for src, dst, n in profile['links']:
+        a, b = groups[src], groups[dst]
+        if a == b:
+            continue
+        adjacency[a][b] = adjacency[a].get(b, 0) + n
+        adjacency[b][a] = adjacency[b].get(a, 0) + n
+
+    target = sum(weight.values()) / num_queues
+    max_load = target * (1 + imbalance)
+    load = [0] * num_queues
+    part = {}
+
+    def connection(group, queue):
+        return sum(cost for other, cost in adjacency[group].items()
+                   if part.get(other) == queue)
+
+    # Grow the queues one after the other from their heaviest object,
+    # adding the objects the most connected to them while they fit
+    for queue in range(num_queues):
+        gain = {}
+        while True:
+            unassigned = [ g for g in weight if g not in part ]
+            if not unassigned:
+                break
+            if queue == num_queues - 1 or load[queue] == 0:
+                fitting = unassigned
+            else:
+                fitting = [ g for g in unassigned
+                            if load[queue] + weight[g] <= max_load ]
+                if load[queue] >= target or not fitting:
+                    break
+            group = max(fitting,
+                        key=lambda g: (gain.get(g, 0), weight[g], g))
+            part[group] = queue
+            load[queue] += weight[group]
+            for other, cost in adjacency[group].items():
+                gain[other] = gain.get(other, 0) + cost
+
+    # Refine the cut
+    for _ in range(10):
+        moved = False
+        for group in sorted(weight):
+            own = part[group]
+            for queue in range(num_queues):
+                if queue == own or \
+                   load[queue] + weight[group] > max_load:
+                    continue
+                delta = connection(group, queue) - connection(group, own)
+                if delta > 0:
+                    load[own] -= weight[group]
+                    load[queue] += weight[group]
+                    part[group] = own = queue
+                    moved = True
+        if not moved:
+            break
+
+    # Swap queue numbers so that root runs on queue 0
+    root_queue = part[groups[root]]
+    def relabel(queue):
+        if queue == root_queue:
+            return 0
+        return root_queue if queue == 0 else queue
+
+    return { path: relabel(part[group]) for path, group in groups.items() }
+
+def cut_connections(profile, assignment):
+    """Return the connections between objects on different queues, split
+    into those through a link object and the direct ones. Objects missing
+    from the assignment are ignored."""
+    objects = profile['objects']
+    through_links, direct = [], []
+    for src, dst, n in profile['links']:
+        if src not in assignment or dst not in assignment or \
+           assignment[src] == assignment[dst]:
+            continue
+        if is_link(objects, src, dst):
+            through_links.append((src, dst))
+        else:
+            direct.append((src, dst))
+    return through_links, direct
+
+def dump(outdir, num_queues):
+    """Partition the objects of the configuration from the events
+    counted during the run, and write the profile and the assignment to
+    eventq_profile.json and eventq_assignment.json in outdir."""
+    import _m5.event
+    from m5.objects import Root
+    from m5.util import inform, warn
+
+    root = Root.getInstance()
+    if root is None:
+        return
+
+    event_counts = { name: entry['count'] for name, entry in
+                     _m5.event.eventProfile().items() }
+    profile = build_profile(root, event_counts)
+    assignment = partition(profile, num_queues)
+
+    with open(os.path.join(outdir, 'eventq_profile.json'), 'w') as f:
+        json.dump(profile, f, indent=4, sort_keys=True)
+    assignment_file = os.path.join(outdir, 'eventq_assignment.json')
+    with open(assignment_file, 'w') as f:
+        json.dump(assignment, f, indent=4, sort_keys=True)
+
+    loads = [0] * num_queues
+    for path, queue in assignment.items():
+        loads[queue] += profile['objects'][path]['events']
+    inform("Event queue assignment written to %s, events per queue: %s",
+           assignment_file, loads)
+
+    used = len(set(assignment.values()))
+    if used < num_queues:
+        warn("Only %d of the %d event queues are used, as the objects can "
+             "only be split at a %s.", used, num_queues,
+             ' or '.join(link_types))
+
+def apply(root, assignment_file):
+    """Set the eventq_index of the objects below root from an assignment
+    written by a profiling run, and return the number of queues. The
+    assignment must not put objects that are connected other than through
+    a link on different queues."""
+    from m5.util import fatal
+
+    with open(assignment_file) as f:
+        assignment = json.load(f)
+
+    _, direct = cut_connections(build_profile(root, {}), assignment)
+    if direct:
+        src, dst = direct[0]
+        fatal("%s puts %s and %s on different event queues, but they are "
+              "connected directly. A direct port call across event queues "
+              "is unsafe at any latency; connections may only be cut at a "
+              "%s.", assignment_file, src, dst, ' or '.join(link_types))
+
+    for obj in root.descendants():
+        if obj.path() in assignment:
+            obj.eventq_index = assignment[obj.path()]
+
+    return max(assignment.values(), default=0) + 1
@@ -0,0 +1,104 @@
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+"""Attribution of the host time of a run to event types and SimObjects.
+
+EventQueue::profileHostTime() times a sample of the events serviced with
+the host cycle counter, and only counts the others. Every sample stands
+for the same share of all the events serviced, which the time and, when
+the events are not counted exactly, the count of every event name are
+extrapolated from. They are then summed per SimObject, the longest
+object path the event name starts with, and per event description.
+"""
+
+import json
+import os
+
+def summarize(event_profile, serviced, object_paths, cycles_per_second):
+    """Estimate the host time spent per event, object and description.
+
+    event_profile maps event names to their description, count, samples
+    and sampled host_cycles, as returned by _m5.event.eventProfile(), and
+    serviced is the number of events serviced while sampling. Returns a
+    dict of three lists sorted by decreasing host time.
+    """
+    samples = sum(entry['samples'] for entry in event_profile.values())
+    scale = serviced / samples if samples else 0
+    events, objects, descriptions = [], {}, {}
+    for name, entry in event_profile.items():
+        count = entry['count'] or round(entry['samples'] * scale)
+        cycles = entry['host_cycles'] * scale
+        seconds = cycles / cycles_per_second if cycles_per_second else 0
+        events.append({
+            'name': name,
+            'description': entry['description'],
+            'count': count,
+            'samples': entry['samples'],
+            'host_seconds': seconds,
+        })
+
+        owner = name
+        while owner and owner not in object_paths:
+            owner = owner.rpartition('.')[0]
+        for key, totals in ((owner or 'unknown', objects),
+                            (entry['description'], descriptions)):
+            key_count, total = totals.get(key, (0, 0))
+            totals[key] = (key_count + count, total + seconds)
+
+    total = sum(e['host_seconds'] for e in events)
+    def table(totals, label):
+        return sorted(({ label: key, 'count': count, 'host_seconds': seconds,
+                         'share': seconds / total if total else 0 }
+                       for key, (count, seconds) in totals.items()),
+                      key=lambda e: (-e['host_seconds'], e[label]))
+
+    return {
+        'host_seconds': total,
+        'events': sorted(events, key=lambda e: (-e['host_seconds'],
+                                                e['name'])),
+        'objects': table(objects, 'object'),
+        'descriptions': table(descriptions, 'description'),
+    }
+
+def dump(outdir, filename):
+    """Write the host time profile of the run to filename in outdir."""
+    import _m5.event
+    from m5.objects import Root
+    from m5.util import inform
+
+    root = Root.getInstance()
+    object_paths = set()
+    if root is not None:
+        object_paths = { obj.path() for obj in root.descendants() }
+
+    summary = summarize(_m5.event.eventProfile(),
+                        _m5.event.eventsServiced(), object_paths,
+                        _m5.event.hostCyclesPerSecond())
+
+    path = os.path.join(outdir, filename)
+    with open(path, 'w') as f:
+        json.dump(summary, f, indent=4)
+
+    top = ', '.join('%s %.1f%%' % (o['object'], 100 * o['share'])
+                    for o in summary['objects'][:5])
+    inform("Host time profile written to %s, top objects: %s", path, top)
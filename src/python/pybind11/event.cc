@@ -40,10 +40,15 @@
  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 
+#include <string>
+#include <unordered_map>
+
 #include "pybind11/pybind11.h"
 #include "pybind11/stl.h"
 
 #include "base/logging.hh"
+#include "base/output.hh"
+#include "sim/core.hh"
 #include "sim/eventq.hh"
 #include "sim/sim_events.hh"
 #include "sim/sim_exit.hh"
@@ -115,6 +120,50 @@ pybind_init_event(py::module_ &m_native)
     m.def("getEventQueue", &getEventQueue,
           py::return_value_policy::reference);
 
+    m.def("declareLookahead",
+          py::overload_cast<uint32_t, uint32_t, Tick>(&declareLookahead),
+          py::arg("src"), py::arg("dst"), py::arg("latency"));
+
+    m.def("profileEvents", &EventQueue::profile);
+    m.def("profileHostTime", &EventQueue::profileHostTime,
+          py::arg("interval"));
+    m.def("hostCyclesPerSecond", &EventQueue::hostCyclesPerSecond);
+    m.def("eventProfile", []() {
+            std::unordered_map<std::string, EventQueue::ProfileEntry> merged;
+            for (const EventQueue *eq : mainEventQueue) {
+                for (const auto &[name, entry] : eq->getProfile()) {
+                    auto &total = merged[name];
+                    total.description = entry.description;
+                    total.count += entry.count;
+                    total.samples += entry.samples;
+                    total.hostCycles += entry.hostCycles;
+                }
+            }
+            py::dict profile;
+            for (const auto &[name, entry] : merged) {
+                profile[py::str(name)] = py::dict(
+                    py::arg("description") = entry.description,
+                    py::arg("count") = entry.count,
+                    py::arg("samples") = entry.samples,
+                    py::arg("host_cycles") = entry.hostCycles);
+            }
+            return profile;
+        });
+    m.def("eventsServiced", []() {
+            Counter serviced = 0;
+            for (const EventQueue *eq : mainEventQueue)
+                serviced += eq->getProfileServiced();
+            return serviced;
+        });
+
+    m.def("trackEventPool", &EventPool::track);
+    m.def("dumpEventPool", [](const std::string &filename) {
+            OutputStream *os = simout.create(filename);
+            EventPool::dump(*os->stream(),
+                            curTick() / sim_clock::as_float::s);
+            simout.close(os);
+        });
+
     py::class_<EventQueue>(m, "EventQueue")
         .def("name",  [](EventQueue *eq) { return eq->name(); })
         .def("dump", &EventQueue::dump)
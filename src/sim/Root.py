@@ -30,6 +30,9 @@ from m5.SimObject import SimObject
 from m5.params import *
 from m5.util import fatal
 
+class EventQueueBackend(ScopedEnum):
+    vals = ['list', 'calendar']
+
 class Root(SimObject):
 
     _the_instance = None
@@ -67,6 +70,17 @@ class Root(SimObject):
     # Needs to be set explicitly for a multi-eventq simulation.
     sim_quantum = Param.Tick(0, "simulation quantum")
 
+    # With lookahead synchronization, the queues only wait on the queues
+    # linked to them, see declareLookahead(). The quantum then bounds the
+    # lookahead of any link and applies to the undeclared ones.
+    lookahead_sync = Param.Bool(False, "synchronize the event queues from "
+        "the lookahead of their links instead of every quantum")
+
+    # The calendar backend makes scheduling cheaper when many events are
+    # pending, both backends process events in the same order.
+    event_queue_backend = Param.EventQueueBackend('list',
+        "data structure used by the main event queues")
+
     full_system = Param.Bool("if this is a full system simulation")
 
     # Time syncing prevents the simulation from running faster than real time.
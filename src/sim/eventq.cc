@@ -30,13 +30,23 @@
 
 #include "sim/eventq.hh"
 
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <cassert>
+#include <chrono>
 #include <iostream>
+#include <map>
 #include <mutex>
 #include <string>
 #include <unordered_map>
 #include <vector>
 
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#include "base/intmath.hh"
 #include "base/logging.hh"
 #include "base/trace.hh"
 #include "cpu/smt.hh"
@@ -58,6 +68,37 @@ std::vector<EventQueue *> mainEventQueue;
 __thread EventQueue *_curEventQueue = NULL;
 bool inParallelMode = false;
 
+EventQueue::Backend EventQueue::defaultBackend = EventQueue::Backend::List;
+bool EventQueue::profiling = false;
+bool EventQueue::countingEvents = false;
+Counter EventQueue::profileInterval = 0;
+uint64_t EventQueue::profileStartCycles = 0;
+double EventQueue::profileStartTime = 0;
+
+namespace
+{
+
+double
+hostSeconds()
+{
+    return std::chrono::duration<double>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/** Host cycle counter, nanoseconds where there is no cheap counter. */
+uint64_t
+hostCycles()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+} // anonymous namespace
+
 EventQueue *
 getEventQueue(uint32_t index)
 {
@@ -70,6 +111,163 @@ getEventQueue(uint32_t index)
     return mainEventQueue[index];
 }
 
+bool EventPool::tracking = false;
+
+namespace
+{
+
+/**
+ * Event pool of a thread. It is never freed, so that the pool can be
+ * dumped at any time, and the memory of its free lists is bounded.
+ */
+struct EventPoolState
+{
+    /** Free blocks of every size class, linked through their first word */
+    std::array<void *, EventPool::numClasses> freeList = {};
+    std::array<std::size_t, EventPool::numClasses> numFree = {};
+
+    /**
+     * Allocations and recycled blocks of every size class, the last
+     * entry counts the events too large for the pool. Only the owning
+     * thread writes them.
+     */
+    std::array<std::atomic<uint64_t>, EventPool::numClasses + 1> allocs = {};
+    std::array<std::atomic<uint64_t>, EventPool::numClasses> recycled = {};
+
+    /** Managed events deleted per description. */
+    std::mutex releasesMutex;
+    std::unordered_map<const char *, uint64_t> releases;
+};
+
+std::mutex poolStatesMutex;
+
+std::vector<EventPoolState *> &
+poolStates()
+{
+    static std::vector<EventPoolState *> states;
+    return states;
+}
+
+thread_local EventPoolState *poolState = nullptr;
+
+EventPoolState &
+localPoolState()
+{
+    if (!poolState) {
+        poolState = new EventPoolState;
+        std::lock_guard<std::mutex> lock(poolStatesMutex);
+        poolStates().push_back(poolState);
+    }
+    return *poolState;
+}
+
+void
+increment(std::atomic<uint64_t> &counter)
+{
+    // Plain load and store, there is a single writer
+    counter.store(counter.load(std::memory_order_relaxed) + 1,
+                  std::memory_order_relaxed);
+}
+
+} // anonymous namespace
+
+void *
+EventPool::allocate(std::size_t size)
+{
+    EventPoolState &state = localPoolState();
+    const std::size_t size_class = size ? (size - 1) / classSize : 0;
+    if (size_class >= numClasses) {
+        increment(state.allocs[numClasses]);
+        return ::operator new(size);
+    }
+
+    increment(state.allocs[size_class]);
+    void *p = state.freeList[size_class];
+    if (!p)
+        return ::operator new((size_class + 1) * classSize);
+
+    increment(state.recycled[size_class]);
+    state.freeList[size_class] = *static_cast<void **>(p);
+    state.numFree[size_class]--;
+    return p;
+}
+
+void
+EventPool::deallocate(void *p, std::size_t size)
+{
+    if (!p)
+        return;
+
+    const std::size_t size_class = size ? (size - 1) / classSize : 0;
+    if (size_class >= numClasses) {
+        ::operator delete(p);
+        return;
+    }
+
+    EventPoolState &state = localPoolState();
+    if (state.numFree[size_class] >= maxFree) {
+        ::operator delete(p);
+        return;
+    }
+
+    *static_cast<void **>(p) = state.freeList[size_class];
+    state.freeList[size_class] = p;
+    state.numFree[size_class]++;
+}
+
+void
+EventPool::countRelease(const char *description)
+{
+    EventPoolState &state = localPoolState();
+    std::lock_guard<std::mutex> lock(state.releasesMutex);
+    state.releases[description]++;
+}
+
+void
+EventPool::dump(std::ostream &os, double seconds)
+{
+    std::array<uint64_t, numClasses + 1> allocs = {};
+    std::array<uint64_t, numClasses> recycled = {};
+    std::map<std::string, uint64_t> releases;
+
+    {
+        std::lock_guard<std::mutex> lock(poolStatesMutex);
+        for (EventPoolState *state : poolStates()) {
+            for (std::size_t i = 0; i <= numClasses; i++)
+                allocs[i] += state->allocs[i].load(std::memory_order_relaxed);
+            for (std::size_t i = 0; i < numClasses; i++) {
+                recycled[i] +=
+                    state->recycled[i].load(std::memory_order_relaxed);
+            }
+
+            std::lock_guard<std::mutex> releases_lock(state->releasesMutex);
+            for (const auto &[description, count] : state->releases)
+                releases[description] += count;
+        }
+    }
+
+    ccprintf(os, "%-16s %16s %16s\n", "size class", "allocations",
+             "recycled");
+    for (std::size_t i = 0; i < numClasses; i++) {
+        if (allocs[i]) {
+            ccprintf(os, "%-16s %16d %16d\n",
+                     csprintf("<= %d bytes", (i + 1) * classSize),
+                     allocs[i], recycled[i]);
+        }
+    }
+    ccprintf(os, "%-16s %16d %16d\n", "larger", allocs[numClasses], 0);
+
+    if (releases.empty())
+        return;
+
+    ccprintf(os, "\n%-40s %16s %16s\n", "managed event", "deleted",
+             "rate (1/s)");
+    for (const auto &[description, count] : releases) {
+        ccprintf(os, "%-40s %16d %16.0f\n", description, count,
+                 seconds > 0 ? count / seconds : 0.0);
+    }
+}
+
 #ifndef NDEBUG
 Counter Event::instanceCounter = 0;
 #endif
@@ -111,6 +309,11 @@ Event::insertBefore(Event *event, Event *curr)
 void
 EventQueue::insert(Event *event)
 {
+    if (backend == Backend::Calendar) {
+        calendarInsert(event);
+        return;
+    }
+
     // Deal with the head case
     if (!head || *event <= *head) {
         head = Event::insertBefore(event, head);
@@ -170,6 +373,11 @@ EventQueue::remove(Event *event)
 
     assert(event->queue == this);
 
+    if (backend == Backend::Calendar) {
+        calendarRemove(event);
+        return;
+    }
+
     // deal with an event on the head's 'in bin' list (event has the same
     // time as the head)
     if (*head == *event) {
@@ -194,14 +402,158 @@ EventQueue::remove(Event *event)
     prev->nextBin = Event::removeItem(event, curr);
 }
 
+void
+EventQueue::calendarInsert(Event *event)
+{
+    Event *&bucket = buckets[bucketIndex(event->when())];
+    Event *bin;
+
+    // Same as insert(), on the bins of a single bucket
+    if (!bucket || *event <= *bucket) {
+        bin = bucket;
+        bucket = Event::insertBefore(event, bucket);
+    } else {
+        Event *prev = bucket;
+        Event *curr = bucket->nextBin;
+        while (curr && *curr < *event) {
+            prev = curr;
+            curr = curr->nextBin;
+        }
+        bin = curr;
+        prev->nextBin = Event::insertBefore(event, curr);
+    }
+
+    // The event is now on top of its bin, which may be the earliest one
+    if (!head || *event <= *head)
+        head = event;
+
+    if (!bin || *bin != *event) {
+        numBins++;
+        if (numBins > 2 * buckets.size())
+            calendarRebuild(orderedBins(), 2 * buckets.size());
+    }
+}
+
+void
+EventQueue::calendarRemove(Event *event)
+{
+    Event *&bucket = buckets[bucketIndex(event->when())];
+    const bool head_bin = *head == *event;
+    Event *top;
+
+    if (!bucket)
+        panic("event not found!");
+
+    if (*bucket == *event) {
+        bucket = Event::removeItem(event, bucket);
+        top = bucket;
+    } else {
+        Event *prev = bucket;
+        Event *curr = bucket->nextBin;
+        while (curr && *curr < *event) {
+            prev = curr;
+            curr = curr->nextBin;
+        }
+
+        if (!curr || *curr != *event)
+            panic("event not found!");
+
+        prev->nextBin = Event::removeItem(event, curr);
+        top = prev->nextBin;
+    }
+
+    if (top && *top == *event) {
+        // Other events are left in the bin, one of them may be on top now
+        if (head_bin)
+            head = top;
+        return;
+    }
+
+    numBins--;
+    if (head_bin)
+        head = calendarFindMin(event->when());
+
+    if (buckets.size() > minBuckets && numBins < buckets.size() / 2)
+        calendarRebuild(orderedBins(), buckets.size() / 2);
+}
+
 Event *
-EventQueue::serviceOne()
+EventQueue::calendarFindMin(Tick from) const
 {
-    std::lock_guard<EventQueue> lock(*this);
-    Event *event = head;
-    Event *next = head->nextInBin;
-    event->flags.clear(Event::Scheduled);
+    if (numBins == 0)
+        return nullptr;
+
+    // Scan one year of the calendar starting at the bucket holding the
+    // given tick. A bucket top scheduled in the bucket's window of the
+    // current year is the earliest bin.
+    const Tick first = from >> bucketShift;
+    for (Tick i = 0; i < buckets.size(); i++) {
+        Event *bin = buckets[(first + i) & (buckets.size() - 1)];
+        if (bin && (bin->when() >> bucketShift) == first + i)
+            return bin;
+    }
+
+    // All the bins are at least a year away, search directly
+    Event *min = nullptr;
+    for (Event *bin : buckets) {
+        if (bin && (!min || *bin < *min))
+            min = bin;
+    }
+    return min;
+}
+
+void
+EventQueue::calendarRebuild(const std::vector<Event *> &bins,
+                            size_t num_buckets)
+{
+    // Estimate the bucket width from the average spacing of the
+    // earliest bins, ignoring outliers of more than twice the average,
+    // so that a few buckets cover the pending events of a year.
+    const size_t samples = std::min<size_t>(bins.size(), 64);
+    if (samples > 1) {
+        const Tick span = bins[samples - 1]->when() - bins[0]->when();
+        const Tick avg = span / (samples - 1);
+        Tick sum = 0;
+        size_t count = 0;
+        for (size_t i = 1; i < samples; i++) {
+            const Tick gap = bins[i]->when() - bins[i - 1]->when();
+            if (gap <= 2 * avg) {
+                sum += gap;
+                count++;
+            }
+        }
+        const Tick width = (count ? sum / count : avg) * 3;
+        bucketShift = width > 1 ? std::min(ceilLog2(width), 63) : 0;
+    }
 
+    buckets.assign(num_buckets, nullptr);
+    std::vector<Event *> tails(num_buckets, nullptr);
+    for (Event *bin : bins) {
+        const size_t idx = bucketIndex(bin->when());
+        if (tails[idx])
+            tails[idx]->nextBin = bin;
+        else
+            buckets[idx] = bin;
+        tails[idx] = bin;
+    }
+    for (Event *tail : tails) {
+        if (tail)
+            tail->nextBin = nullptr;
+    }
+
+    numBins = bins.size();
+    head = bins.empty() ? nullptr : bins.front();
+}
+
+void
+EventQueue::popHead()
+{
+    if (backend == Backend::Calendar) {
+        calendarRemove(head);
+        return;
+    }
+
+    Event *next = head->nextInBin;
     if (next) {
         // update the next bin pointer since it could be stale
         next->nextBin = head->nextBin;
@@ -213,6 +565,135 @@ EventQueue::serviceOne()
         // the 'in bin' list and point to the next bin list
         head = head->nextBin;
     }
+}
+
+std::vector<Event *>
+EventQueue::orderedBins() const
+{
+    std::vector<Event *> bins;
+
+    if (backend == Backend::List) {
+        for (Event *bin = head; bin; bin = bin->nextBin)
+            bins.push_back(bin);
+        return bins;
+    }
+
+    bins.reserve(numBins);
+    for (Event *bucket : buckets) {
+        for (Event *bin = bucket; bin; bin = bin->nextBin)
+            bins.push_back(bin);
+    }
+    std::sort(bins.begin(), bins.end(),
+              [](const Event *a, const Event *b) { return *a < *b; });
+    return bins;
+}
+
+Event *
+EventQueue::exportBins()
+{
+    Event *bins = head;
+
+    if (backend == Backend::Calendar) {
+        const std::vector<Event *> ordered = orderedBins();
+        for (size_t i = 0; i < ordered.size(); i++)
+            ordered[i]->nextBin = i + 1 < ordered.size() ?
+                ordered[i + 1] : nullptr;
+        std::fill(buckets.begin(), buckets.end(), nullptr);
+        numBins = 0;
+    }
+
+    head = nullptr;
+    return bins;
+}
+
+void
+EventQueue::importBins(Event *bins)
+{
+    assert(empty());
+
+    if (backend == Backend::List) {
+        head = bins;
+        return;
+    }
+
+    std::vector<Event *> ordered;
+    for (Event *bin = bins; bin; bin = bin->nextBin)
+        ordered.push_back(bin);
+
+    size_t num_buckets = minBuckets;
+    while (num_buckets < ordered.size())
+        num_buckets *= 2;
+    calendarRebuild(ordered, num_buckets);
+}
+
+void
+EventQueue::setBackend(Backend b)
+{
+    if (b == backend)
+        return;
+
+    Event *bins = exportBins();
+    backend = b;
+    if (backend == Backend::Calendar)
+        buckets.assign(minBuckets, nullptr);
+    else
+        buckets.clear();
+    importBins(bins);
+}
+
+void
+EventQueue::profile(bool enable)
+{
+    countingEvents = enable;
+    profiling = countingEvents || profileInterval;
+}
+
+void
+EventQueue::profileHostTime(Counter interval)
+{
+    fatal_if(interval < 0, "Invalid host profiling interval %d.", interval);
+    profileInterval = interval;
+    profiling = countingEvents || profileInterval;
+    profileStartCycles = hostCycles();
+    profileStartTime = hostSeconds();
+}
+
+double
+EventQueue::hostCyclesPerSecond()
+{
+    const double elapsed = hostSeconds() - profileStartTime;
+    if (elapsed <= 0)
+        return 0;
+    return (hostCycles() - profileStartCycles) / elapsed;
+}
+
+EventQueue::ProfileEntry &
+EventQueue::profileEntry(const Event *event)
+{
+    auto [it, inserted] = profileCounts.try_emplace(event->name());
+    if (inserted)
+        it->second.description = event->description();
+    return it->second;
+}
+
+Counter
+EventQueue::nextProfileCountdown()
+{
+    // xorshift64, uniform in [1, 2 * interval - 1] to average interval
+    profileSeed ^= profileSeed << 13;
+    profileSeed ^= profileSeed >> 7;
+    profileSeed ^= profileSeed << 17;
+    return 1 + profileSeed % (2 * profileInterval - 1);
+}
+
+Event *
+EventQueue::serviceOne()
+{
+    std::lock_guard<EventQueue> lock(*this);
+    Event *event = head;
+    event->flags.clear(Event::Scheduled);
+
+    popHead();
 
     // handle action
     if (!event->squashed()) {
@@ -220,7 +701,25 @@ EventQueue::serviceOne()
         setCurTick(event->when());
         if (debug::Event)
             event->trace("executed");
+        ProfileEntry *timed = nullptr;
+        uint64_t start = 0;
+        if (profiling) {
+            if (countingEvents)
+                profileEntry(event).count++;
+            if (profileInterval) {
+                profileServiced++;
+                if (--profileCountdown <= 0) {
+                    profileCountdown = nextProfileCountdown();
+                    timed = &profileEntry(event);
+                    start = hostCycles();
+                }
+            }
+        }
         event->process();
+        if (timed) {
+            timed->hostCycles += hostCycles() - start;
+            timed->samples++;
+        }
         if (event->isExitEvent()) {
             assert(!event->flags.isSet(Event::Managed) ||
                    !event->flags.isSet(Event::IsMainQueue)); // would be silly
@@ -295,15 +794,12 @@ EventQueue::dump() const
     if (empty())
         cprintf("<No Events>\n");
     else {
-        Event *nextBin = head;
-        while (nextBin) {
+        for (Event *nextBin : orderedBins()) {
             Event *nextInBin = nextBin;
             while (nextInBin) {
                 nextInBin->dump();
                 nextInBin = nextInBin->nextInBin;
             }
-
-            nextBin = nextBin->nextBin;
         }
     }
 
@@ -318,8 +814,7 @@ EventQueue::debugVerify() const
     Tick time = 0;
     short priority = 0;
 
-    Event *nextBin = head;
-    while (nextBin) {
+    for (Event *nextBin : orderedBins()) {
         Event *nextInBin = nextBin;
         while (nextInBin) {
             if (nextInBin->when() < time) {
@@ -345,8 +840,6 @@ EventQueue::debugVerify() const
 
             nextInBin = nextInBin->nextInBin;
         }
-
-        nextBin = nextBin->nextBin;
     }
 
     return true;
@@ -355,8 +848,8 @@ EventQueue::debugVerify() const
 Event*
 EventQueue::replaceHead(Event* s)
 {
-    Event* t = head;
-    head = s;
+    Event* t = exportBins();
+    importBins(s);
     return t;
 }
 
@@ -416,8 +909,11 @@ Event::dump() const
 }
 
 EventQueue::EventQueue(const std::string &n)
-    : objName(n), head(NULL), _curTick(0)
+    : objName(n), head(NULL), _curTick(0), backend(Backend::List),
+      bucketShift(10), numBins(0), profileServiced(0), profileCountdown(0),
+      profileSeed(std::hash<std::string>()(n) | 1)
 {
+    setBackend(defaultBackend);
 }
 
 void
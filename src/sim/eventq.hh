@@ -38,11 +38,14 @@
 #include <algorithm>
 #include <cassert>
 #include <climits>
+#include <cstddef>
 #include <functional>
 #include <iosfwd>
 #include <list>
 #include <memory>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 #include "base/debug.hh"
 #include "base/flags.hh"
@@ -241,6 +244,50 @@ class EventBase
     static const Priority Maximum_Pri =          SCHAR_MAX;
 };
 
+/**
+ * Thread local, size classed free lists for heap allocated events.
+ *
+ * Transient events, such as AutoDelete events created for a single
+ * response, are allocated and deleted at a high rate. Event overrides
+ * operator new and delete to recycle their memory through this pool.
+ * Every thread keeps a bounded free list per size class, so allocating
+ * and deleting an event does not take any lock in the common case.
+ */
+class EventPool
+{
+  public:
+    /** Granularity of the size classes, in bytes. */
+    static constexpr std::size_t classSize = 16;
+
+    /** Number of size classes, larger events bypass the pool. */
+    static constexpr std::size_t numClasses = 16;
+
+    /** Maximum number of free blocks a thread keeps per size class. */
+    static constexpr std::size_t maxFree = 4096;
+
+    static void *allocate(std::size_t size);
+    static void deallocate(void *p, std::size_t size);
+
+    /** Count the deleted managed events per description. */
+    static void track(bool enable) { tracking = enable; }
+    static bool isTracking() { return tracking; }
+
+    /** Account for the deletion of a managed event. */
+    static void countRelease(const char *description);
+
+    /**
+     * Print the allocations and recycled blocks of every size class,
+     * and, when tracking, the deleted managed events per description,
+     * summed over all threads.
+     *
+     * @param seconds Simulated time, used to print deletion rates.
+     */
+    static void dump(std::ostream &os, double seconds = 0);
+
+  private:
+    static bool tracking;
+};
+
 /*
  * An item on an event queue.  The action caused by a given
  * event is specified by deriving a subclass and overriding the
@@ -397,12 +444,36 @@ class Event : public EventBase, public Serializable
     virtual void acquireImpl() {}
 
     virtual void releaseImpl() {
-        if (!scheduled())
+        if (!scheduled()) {
+            if (EventPool::isTracking())
+                EventPool::countRelease(description());
             delete this;
+        }
     }
 
     /** @} */
 
+  public:
+    /**
+     * @{
+     * Heap allocated events are recycled through the EventPool.
+     */
+    static void *
+    operator new(std::size_t size)
+    {
+        return EventPool::allocate(size);
+    }
+
+    static void
+    operator delete(void *p, std::size_t size)
+    {
+        EventPool::deallocate(p, size);
+    }
+
+    static void *operator new(std::size_t, void *p) { return p; }
+    static void operator delete(void *, void *) {}
+    /** @} */
+
   public:
 
     /*
@@ -621,6 +692,23 @@ operator!=(const Event &l, const Event &r)
  */
 class EventQueue
 {
+  public:
+    /**
+     * Data structure used to order the bins of simultaneous events.
+     * Events within a bin are always kept on a LIFO list, so both
+     * backends service events in exactly the same order.
+     */
+    enum class Backend
+    {
+        /** Sorted list of bins, linear time inserts. */
+        List,
+        /**
+         * Calendar queue of bins (Brown, CACM 1988), amortized constant
+         * time inserts and removes when many events are pending.
+         */
+        Calendar
+    };
+
   private:
     friend void curEventQueue(EventQueue *);
 
@@ -628,6 +716,101 @@ class EventQueue
     Event *head;
     Tick _curTick;
 
+    Backend backend;
+
+    /** Backend used by newly created event queues. */
+    static Backend defaultBackend;
+
+    /**
+     * Calendar buckets. Each bucket holds the bins whose tick falls in
+     * it modulo the calendar length as a sorted list linked through
+     * Event::nextBin. The head pointer caches the earliest bin.
+     */
+    std::vector<Event *> buckets;
+    /** Log2 of the number of ticks covered by a calendar bucket. */
+    unsigned bucketShift;
+    /** Number of bins stored in the calendar. */
+    size_t numBins;
+
+    /** Smallest calendar, the calendar never shrinks below this. */
+    static constexpr size_t minBuckets = 16;
+
+  public:
+    /** What the profile records about the events sharing a name. */
+    struct ProfileEntry
+    {
+        std::string description;
+        /** Events serviced, if counting them, see profile(). */
+        Counter count = 0;
+        /** Events whose process() was timed. */
+        Counter samples = 0;
+        /** Host cycles spent in the process() of the timed events. */
+        uint64_t hostCycles = 0;
+    };
+
+  private:
+    /** Whether any profiling is enabled. */
+    static bool profiling;
+    /** Whether to count the events serviced, see profile(). */
+    static bool countingEvents;
+    /** Mean number of events between two timed ones, 0 to never time. */
+    static Counter profileInterval;
+    /** Host cycle counter and time when host profiling started. */
+    static uint64_t profileStartCycles;
+    static double profileStartTime;
+
+    /** Events serviced by this queue per event name. */
+    std::unordered_map<std::string, ProfileEntry> profileCounts;
+    /** Events serviced by this queue while sampling the host time. */
+    Counter profileServiced;
+    /** Events left to service before timing one. */
+    Counter profileCountdown;
+    /** State of the generator jittering the sampling interval. */
+    uint64_t profileSeed;
+
+    /** Events to service before timing the next one. */
+    Counter nextProfileCountdown();
+
+    /** Profile entry of an event, created on first use. */
+    ProfileEntry &profileEntry(const Event *event);
+
+    size_t
+    bucketIndex(Tick when) const
+    {
+        return (when >> bucketShift) & (buckets.size() - 1);
+    }
+
+    void calendarInsert(Event *event);
+    void calendarRemove(Event *event);
+
+    /**
+     * Find the earliest bin in the calendar, knowing that no bin is
+     * scheduled before the given tick.
+     */
+    Event *calendarFindMin(Tick from) const;
+
+    /**
+     * Redistribute sorted bins over a calendar with the given number of
+     * buckets, estimating a new bucket width from their spacing.
+     */
+    void calendarRebuild(const std::vector<Event *> &bins,
+                         size_t num_buckets);
+
+    /** Remove the event at the head of the queue. */
+    void popHead();
+
+    /** All bins of the queue, sorted by tick and priority. */
+    std::vector<Event *> orderedBins() const;
+
+    /**
+     * Detach all bins from the queue and return them as a sorted list
+     * linked through Event::nextBin, leaving the queue empty.
+     */
+    Event *exportBins();
+
+    /** Move a sorted list of bins into an empty queue. */
+    void importBins(Event *bins);
+
     //! Mutex to protect async queue.
     UncontendedMutex async_queue_mutex;
 
@@ -747,6 +930,45 @@ class EventQueue
      */
     EventQueue(const std::string &n);
 
+    /**
+     * Switch this queue to a different backend. Pending events are
+     * moved over and keep their relative order.
+     */
+    void setBackend(Backend b);
+    Backend getBackend() const { return backend; }
+
+    /** Set the backend used by event queues created from now on. */
+    static void setDefaultBackend(Backend b) { defaultBackend = b; }
+    static Backend getDefaultBackend() { return defaultBackend; }
+
+    /**
+     * Count the events serviced by every queue per event name. Event
+     * names start with the name of their object, so this tells how
+     * busy each object keeps the queues.
+     */
+    static void profile(bool enable);
+
+    /**
+     * Time the process() of one in about interval events with the host
+     * cycle counter, or stop if interval is 0. The interval is jittered
+     * so that sampling does not lock onto periodic events. Only the
+     * sampled events are looked up in the profile, the others are just
+     * counted per queue, see getProfileServiced().
+     */
+    static void profileHostTime(Counter interval);
+
+    /** Host cycles per second, measured since profileHostTime(). */
+    static double hostCyclesPerSecond();
+
+    const std::unordered_map<std::string, ProfileEntry> &
+    getProfile() const
+    {
+        return profileCounts;
+    }
+
+    /** Events serviced while sampling, to scale up the samples. */
+    Counter getProfileServiced() const { return profileServiced; }
+
     /**
      * @ingroup api_eventq
      * @{
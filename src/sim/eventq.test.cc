@@ -0,0 +1,224 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <random>
+#include <sstream>
+#include <vector>
+
+#include "sim/eventq.hh"
+
+using namespace gem5;
+
+namespace
+{
+
+/**
+ * Service a random mix of schedules, reschedules and deschedules,
+ * optionally switching backends on the way, and return the order in
+ * which events were processed.
+ */
+std::vector<int>
+runWorkload(EventQueue::Backend backend, unsigned seed,
+            unsigned switch_every = 0)
+{
+    std::vector<std::unique_ptr<EventFunctionWrapper>> events;
+    EventQueue eq("eq");
+    eq.setBackend(backend);
+
+    std::mt19937 rng(seed);
+    std::vector<int> order;
+
+    // Mostly short delays, and a few far away events
+    auto delay = [&rng]() -> Tick {
+        switch (rng() % 4) {
+          case 0: return 0;
+          case 1: return rng() % 16;
+          case 2: return rng() % 1000;
+          default: return rng() % 1000000;
+        }
+    };
+
+    for (int i = 0; i < 512; i++) {
+        auto callback = [&, i]() {
+            order.push_back(i);
+            for (int n = 0; n < 2; n++) {
+                Event *other = events[rng() % events.size()].get();
+                const Tick when = eq.getCurTick() + delay();
+                if (!other->scheduled())
+                    eq.schedule(other, when);
+                else if (rng() % 2)
+                    eq.reschedule(other, when);
+                else
+                    eq.deschedule(other);
+            }
+        };
+        const Event::Priority prio = Event::Default_Pri + rng() % 3 - 1;
+        events.emplace_back(
+            new EventFunctionWrapper(callback, "event", false, prio));
+        if (i % 2)
+            eq.schedule(events.back().get(), delay());
+    }
+
+    while (!eq.empty() && order.size() < 50000) {
+        if (switch_every && order.size() % switch_every == 0) {
+            eq.setBackend(eq.getBackend() == EventQueue::Backend::List ?
+                EventQueue::Backend::Calendar : EventQueue::Backend::List);
+        }
+        eq.serviceOne();
+    }
+
+    EXPECT_TRUE(eq.debugVerify());
+    return order;
+}
+
+} // anonymous namespace
+
+/** The calendar backend processes events in the same order as the list */
+TEST(EventQueueTest, CalendarMatchesList)
+{
+    for (unsigned seed = 0; seed < 8; seed++) {
+        const auto list = runWorkload(EventQueue::Backend::List, seed);
+        const auto calendar =
+            runWorkload(EventQueue::Backend::Calendar, seed);
+        ASSERT_EQ(list.size(), calendar.size());
+        ASSERT_EQ(list, calendar);
+    }
+}
+
+/** Pending events keep their order when switching backends */
+TEST(EventQueueTest, SwitchBackend)
+{
+    const auto list = runWorkload(EventQueue::Backend::List, 1);
+    const auto mixed = runWorkload(EventQueue::Backend::List, 1, 997);
+    ASSERT_EQ(list, mixed);
+}
+
+/** Swapping the queue contents out and back in preserves them */
+TEST(EventQueueTest, CalendarReplaceHead)
+{
+    EventQueue eq("eq");
+    eq.setBackend(EventQueue::Backend::Calendar);
+
+    std::vector<int> order;
+    std::vector<std::unique_ptr<EventFunctionWrapper>> events;
+    for (int i = 0; i < 64; i++) {
+        events.emplace_back(new EventFunctionWrapper(
+            [&order, i]() { order.push_back(i); }, "event"));
+    }
+
+    // Schedule the odd events in reverse order, in pairs on the same tick
+    for (int i = 63; i > 0; i -= 2)
+        eq.schedule(events[i].get(), 100 + i / 4);
+
+    Event *saved = eq.replaceHead(nullptr);
+    ASSERT_TRUE(eq.empty());
+    for (int i = 0; i < 64; i += 2)
+        eq.schedule(events[i].get(), 10 + i);
+    while (!eq.empty())
+        eq.serviceOne();
+
+    eq.replaceHead(saved);
+    ASSERT_TRUE(eq.debugVerify());
+    while (!eq.empty())
+        eq.serviceOne();
+
+    std::vector<int> expected;
+    for (int i = 0; i < 64; i += 2)
+        expected.push_back(i);
+    // Events on the same tick are processed in LIFO order
+    for (int i = 1; i < 64; i += 4) {
+        expected.push_back(i);
+        expected.push_back(i + 2);
+    }
+    ASSERT_EQ(order, expected);
+}
+
+/** Deleted events are recycled by the next allocation of their size */
+TEST(EventPoolTest, RecycleAutoDelete)
+{
+    EventQueue eq("eq");
+    EventPool::track(true);
+
+    int processed = 0;
+    auto callback = [&processed]() { processed++; };
+    Event *first = new EventFunctionWrapper(callback, "transient", true);
+    eq.schedule(first, 10);
+    eq.serviceOne();
+    ASSERT_EQ(processed, 1);
+
+    Event *second = new EventFunctionWrapper(callback, "transient", true);
+    EXPECT_EQ(first, second);
+    eq.schedule(second, 20);
+    eq.deschedule(second);
+
+    EventPool::track(false);
+
+    std::ostringstream os;
+    EventPool::dump(os);
+    EXPECT_NE(os.str().find("EventFunctionWrapped"), std::string::npos);
+}
+
+TEST(EventQueueTest, ProfileHostTime)
+{
+    EventQueue eq("eq");
+    EventQueue::profileHostTime(1);
+
+    int processed = 0;
+    EventFunctionWrapper tick([&processed]() { processed++; }, "cpu.tick");
+    for (Tick when = 1; when <= 5; when++) {
+        eq.schedule(&tick, when);
+        eq.serviceOne();
+    }
+    ASSERT_EQ(processed, 5);
+
+    // Only sampling, the events are counted per queue and not per name.
+    const auto &profile = eq.getProfile();
+    ASSERT_EQ(profile.size(), 1u);
+    const auto &entry = profile.at(tick.name());
+    EXPECT_EQ(entry.description, tick.description());
+    EXPECT_EQ(entry.count, 0);
+    EXPECT_EQ(entry.samples, 5);
+    EXPECT_EQ(eq.getProfileServiced(), 5);
+    EXPECT_GE(EventQueue::hostCyclesPerSecond(), 0);
+
+    // Counting as well.
+    EventQueue::profile(true);
+    eq.schedule(&tick, 6);
+    eq.serviceOne();
+    EXPECT_EQ(entry.count, 1);
+    EXPECT_EQ(entry.samples, 6);
+    EXPECT_EQ(eq.getProfileServiced(), 6);
+
+    EventQueue::profile(false);
+    EventQueue::profileHostTime(0);
+    eq.schedule(&tick, 7);
+    eq.serviceOne();
+    EXPECT_EQ(entry.count, 1);
+    EXPECT_EQ(entry.samples, 6);
+    EXPECT_EQ(eq.getProfileServiced(), 6);
+}
@@ -0,0 +1,148 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Host time microbenchmark of the event queue backends. It runs the
+ * classic hold model: a fixed number of events are pending, and every
+ * serviced event schedules itself again after a random delay. For each
+ * queue size and delay distribution it reports the host time per
+ * serviced event of every backend, which shows from how many pending
+ * events on the calendar queue beats the sorted list.
+ */
+
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "base/cprintf.hh"
+#include "sim/eventq.hh"
+
+namespace gem5
+{
+namespace
+{
+
+struct Distribution
+{
+    const char *name;
+    std::function<Tick(std::mt19937_64 &)> delay;
+};
+
+const std::vector<Distribution> distributions = {
+    // Clocked objects waking up a few cycles later, many ties
+    {"clocked", [](std::mt19937_64 &rng) { return 500 * (1 + rng() % 8); }},
+    // Spread out delays, few ties
+    {"uniform", [](std::mt19937_64 &rng) { return 1 + rng() % 100000; }},
+    // Mostly short delays with some long timers
+    {"bimodal", [](std::mt19937_64 &rng) {
+        return rng() % 16 ? 1 + rng() % 1000 : 1 + rng() % 10000000;
+    }},
+};
+
+/** @return Host nanoseconds per serviced event. */
+double
+run(EventQueue::Backend backend, const Distribution &dist,
+    unsigned num_pending, uint64_t num_events)
+{
+    std::mt19937_64 rng(0);
+    std::vector<std::unique_ptr<EventFunctionWrapper>> events;
+    EventQueue eq("bench");
+    eq.setBackend(backend);
+
+    for (unsigned i = 0; i < num_pending; i++) {
+        EventFunctionWrapper *event = nullptr;
+        event = new EventFunctionWrapper([&, i]() {
+            eq.schedule(events[i].get(), eq.getCurTick() + dist.delay(rng));
+        }, "hold");
+        events.emplace_back(event);
+        eq.schedule(event, dist.delay(rng));
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    for (uint64_t i = 0; i < num_events; i++)
+        eq.serviceOne();
+    const std::chrono::duration<double, std::nano> elapsed =
+        std::chrono::steady_clock::now() - start;
+
+    while (!eq.empty())
+        eq.deschedule(eq.getHead());
+
+    return elapsed.count() / num_events;
+}
+
+void
+usage(const char *name)
+{
+    cprintf("Usage: %s [--events N] [--max-pending N]\n", name);
+}
+
+} // anonymous namespace
+} // namespace gem5
+
+int
+main(int argc, char **argv)
+{
+    using namespace gem5;
+
+    uint64_t num_events = 1 << 16;
+    unsigned max_pending = 1 << 14;
+
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        if (i + 1 == argc) {
+            usage(argv[0]);
+            return 1;
+        }
+        const std::string value = argv[++i];
+        if (arg == "--events") {
+            num_events = std::stoull(value);
+        } else if (arg == "--max-pending") {
+            max_pending = std::stoul(value);
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+
+    cprintf("%d events serviced per run\n", num_events);
+    cprintf("%-8s %10s %14s %14s\n", "delays", "pending",
+            "list ns/event", "cal. ns/event");
+    for (const auto &dist : distributions) {
+        for (unsigned pending = 4; pending <= max_pending; pending *= 4) {
+            const double list = run(EventQueue::Backend::List, dist,
+                                    pending, num_events);
+            const double calendar = run(EventQueue::Backend::Calendar, dist,
+                                        pending, num_events);
+            cprintf("%-8s %10d %14.2f %14.2f\n", dist.name, pending, list,
+                    calendar);
+        }
+    }
+
+    return 0;
+}
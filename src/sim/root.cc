@@ -43,11 +43,13 @@
 #include "base/logging.hh"
 #include "base/trace.hh"
 #include "debug/TimeSync.hh"
+#include "enums/EventQueueBackend.hh"
 #include "sim/core.hh"
 #include "sim/cur_tick.hh"
 #include "sim/eventq.hh"
 #include "sim/full_system.hh"
 #include "sim/root.hh"
+#include "sim/simulate.hh"
 
 namespace gem5
 {
@@ -187,6 +189,14 @@ Root::Root(const RootParams &p, int)
     lastTime.setTimer();
 
     simQuantum = p.sim_quantum;
+    lookaheadSync = p.lookahead_sync;
+
+    const EventQueue::Backend backend =
+        p.event_queue_backend == EventQueueBackend::calendar ?
+        EventQueue::Backend::Calendar : EventQueue::Backend::List;
+    EventQueue::setDefaultBackend(backend);
+    for (EventQueue *eq : mainEventQueue)
+        eq->setBackend(backend);
 
     // Some of the statistics are global and need to be accessed by
     // stat formulas. The most convenient way to implement that is by
@@ -42,9 +42,14 @@
 
 #include "sim/simulate.hh"
 
+#include <algorithm>
 #include <atomic>
+#include <map>
+#include <memory>
 #include <mutex>
 #include <thread>
+#include <utility>
+#include <vector>
 
 #include "base/logging.hh"
 #include "base/pollevent.hh"
@@ -63,6 +68,146 @@ Event *doSimLoop(EventQueue *);
 
 GlobalSimLoopExitEvent *simulate_limit_event = nullptr;
 
+bool lookaheadSync = false;
+
+/**
+ * State of the lookahead synchronization of the main event queues.
+ *
+ * @see lookaheadSync
+ */
+class LookaheadSync
+{
+  public:
+    void
+    declare(uint32_t src, uint32_t dst, Tick latency)
+    {
+        fatal_if(latency == 0, "Event queue %d cannot schedule events on "
+                 "event queue %d without a lookahead.", src, dst);
+
+        auto [it, inserted] = declared.emplace(std::make_pair(src, dst),
+                                               latency);
+        if (!inserted)
+            it->second = std::min(it->second, latency);
+    }
+
+    /**
+     * Resolve the lookahead of every pair of queues and reset the
+     * bounds of the queues before they start running.
+     */
+    void
+    start()
+    {
+        if (numQueues != numMainEventQueues) {
+            numQueues = numMainEventQueues;
+            bounds.reset(new Bound[numQueues]);
+        }
+
+        lookahead.assign(numQueues * numQueues, simQuantum);
+        for (const auto &[queues, latency] : declared) {
+            const auto [src, dst] = queues;
+            if (src < numQueues && dst < numQueues) {
+                lookahead[src * numQueues + dst] =
+                    std::min(latency, simQuantum);
+            }
+        }
+
+        for (uint32_t i = 0; i < numQueues; i++)
+            publish(i, mainEventQueue[i]->getCurTick());
+    }
+
+    /** Set the lower bound on the time of the events of a queue. */
+    void
+    publish(uint32_t queue, Tick bound)
+    {
+        bounds[queue].tick.store(bound, std::memory_order_release);
+    }
+
+    /** @return The time before which no event can reach the queue. */
+    Tick
+    horizon(uint32_t queue) const
+    {
+        Tick horizon = MaxTick;
+        for (uint32_t src = 0; src < numQueues; src++) {
+            if (src == queue)
+                continue;
+            const Tick bound =
+                bounds[src].tick.load(std::memory_order_acquire);
+            const Tick latency = lookahead[src * numQueues + queue];
+            horizon = std::min(horizon,
+                bound > MaxTick - latency ? MaxTick : bound + latency);
+        }
+        return horizon;
+    }
+
+    /**
+     * Wait until the next event of a queue is before its horizon,
+     * merging the events scheduled on it by other queues meanwhile.
+     *
+     * @return The new horizon of the queue.
+     */
+    Tick
+    wait(uint32_t queue, EventQueue *eventq)
+    {
+        for (unsigned spins = 1; ; spins++) {
+            const Tick horizon = this->horizon(queue);
+            eventq->handleAsyncInsertions();
+
+            // While waiting, the queue will not process anything before
+            // its horizon, and cannot receive anything before it either
+            const Tick next = eventq->nextTick();
+            publish(queue, std::min(next, horizon));
+            if (next < horizon)
+                return horizon;
+
+            if (spins % 64 == 0)
+                std::this_thread::yield();
+        }
+    }
+
+  private:
+    /** Bound of a queue, on a cache line of its own. */
+    struct alignas(64) Bound
+    {
+        std::atomic<Tick> tick;
+    };
+
+    uint32_t numQueues = 0;
+    std::unique_ptr<Bound[]> bounds;
+
+    /** Lookahead of every pair of queues, indexed by src * N + dst. */
+    std::vector<Tick> lookahead;
+
+    /** Smallest latency declared for every pair of queues. */
+    std::map<std::pair<uint32_t, uint32_t>, Tick> declared;
+};
+
+static LookaheadSync lookaheadSyncState;
+
+void
+declareLookahead(uint32_t src, uint32_t dst, Tick latency)
+{
+    lookaheadSyncState.declare(src, dst, latency);
+}
+
+void
+declareLookahead(EventQueue *src, EventQueue *dst, Tick latency)
+{
+    if (src == dst)
+        return;
+
+    auto src_it = std::find(mainEventQueue.begin(), mainEventQueue.end(),
+                            src);
+    auto dst_it = std::find(mainEventQueue.begin(), mainEventQueue.end(),
+                            dst);
+    panic_if(src_it == mainEventQueue.end() ||
+             dst_it == mainEventQueue.end(),
+             "Lookahead declared for an event queue that is not a main "
+             "event queue.");
+
+    declareLookahead(src_it - mainEventQueue.begin(),
+                     dst_it - mainEventQueue.begin(), latency);
+}
+
 class SimulatorThreads
 {
   public:
@@ -207,9 +352,13 @@ simulate(Tick num_cycles)
         fatal_if(simQuantum == 0,
                  "Quantum for multi-eventq simulation not specified");
 
-        quantum_event.reset(
-            new GlobalSyncEvent(curTick() + simQuantum, simQuantum,
-                                EventBase::Progress_Event_Pri, 0));
+        if (lookaheadSync) {
+            lookaheadSyncState.start();
+        } else {
+            quantum_event.reset(
+                new GlobalSyncEvent(curTick() + simQuantum, simQuantum,
+                                    EventBase::Progress_Event_Pri, 0));
+        }
 
         inParallelMode = true;
     }
@@ -272,10 +421,24 @@ doSimLoop(EventQueue *eventq)
     curEventQueue(eventq);
     eventq->handleAsyncInsertions();
 
+    // With lookahead synchronization, events before the horizon can no
+    // longer be preceded by events from the other queues
+    const bool lookahead = inParallelMode && lookaheadSync;
+    const uint32_t queue = std::find(mainEventQueue.begin(),
+        mainEventQueue.end(), eventq) - mainEventQueue.begin();
+    Tick horizon = 0;
+
     while (1) {
         // there should always be at least one event (the SimLoopExitEvent
         // we just scheduled) in the queue
         assert(!eventq->empty());
+
+        if (lookahead) {
+            if (eventq->nextTick() >= horizon)
+                horizon = lookaheadSyncState.wait(queue, eventq);
+            lookaheadSyncState.publish(queue, eventq->nextTick());
+        }
+
         assert(curTick() <= eventq->nextTick() &&
                "event scheduled in the past");
 
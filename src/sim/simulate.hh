@@ -38,13 +38,52 @@
  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 
+#include <cstdint>
+
 #include "base/types.hh"
 
 namespace gem5
 {
 
+class EventQueue;
 class GlobalSimLoopExitEvent;
 
+/**
+ * Synchronize the main event queues from the lookahead of the links
+ * between them rather than with a global barrier every simQuantum.
+ *
+ * Every queue publishes a lower bound on the time of the events it
+ * will still process, and runs its events as long as they are before
+ * the bounds of the other queues plus the lookahead of their links to
+ * it, since no event can be scheduled on it from these queues before
+ * that. A thread then only waits on the queues that actually limit it.
+ *
+ * As events from other queues are merged as soon as they are safe,
+ * events of different queues scheduled on the same tick with the same
+ * priority may be processed in a different order from run to run.
+ */
+extern bool lookaheadSync;
+
+/**
+ * Declare that events scheduled from one main event queue on another
+ * are always at least the given latency in the future. The smallest
+ * latency declared for a pair of queues is its lookahead. Pairs
+ * without a declared latency, and latencies beyond simQuantum, use
+ * simQuantum, which also bounds how far apart any two queues may be
+ * and thus keeps global events safe.
+ *
+ * @param src Index of the queue the events are scheduled from.
+ * @param dst Index of the queue the events are scheduled on.
+ * @param latency Minimum delay of the events, must not be 0.
+ */
+void declareLookahead(uint32_t src, uint32_t dst, Tick latency);
+
+/**
+ * Declare the lookahead between the queues of two objects, doing
+ * nothing if they share a queue.
+ */
+void declareLookahead(EventQueue *src, EventQueue *dst, Tick latency);
+
 GlobalSimLoopExitEvent *simulate(Tick num_cycles = MaxTick);
 
 /**
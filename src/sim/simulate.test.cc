@@ -0,0 +1,145 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <vector>
+
+#include "sim/eventq.hh"
+#include "sim/global_event.hh"
+#include "sim/sim_events.hh"
+#include "sim/simulate.hh"
+
+using namespace gem5;
+
+namespace
+{
+
+/**
+ * A node of a ring of event queues. It ticks on its own queue, and every
+ * tick sends a message to the next queue exactly the latency of their
+ * link later. Each node also records the last tick its queue serviced,
+ * so that a message merged after its queue went past it is caught.
+ */
+class Node
+{
+  public:
+    Node(int id, EventQueue *eq, Tick latency)
+        : eq(eq), period(97 + id), latency(latency),
+          tick([this]() { process(); }, "tick")
+    {
+        eq->schedule(&tick, 10);
+    }
+
+    ~Node()
+    {
+        if (tick.scheduled())
+            eq->deschedule(&tick);
+    }
+
+    void
+    process()
+    {
+        service();
+
+        const Tick when = eq->getCurTick() + latency;
+        Node *dst = next;
+        dst->eq->schedule(new EventFunctionWrapper([dst, when]() {
+                dst->service();
+                dst->received++;
+            }, "message", true), when);
+        sent++;
+
+        eq->schedule(&tick, eq->getCurTick() + period);
+    }
+
+    /** Check that the events of the queue are serviced in order. */
+    void
+    service()
+    {
+        if (eq->getCurTick() < lastServiced)
+            late++;
+        lastServiced = eq->getCurTick();
+    }
+
+    EventQueue *eq;
+    Node *next = nullptr;
+    const Tick period;
+    const Tick latency;
+    EventFunctionWrapper tick;
+
+    Tick lastServiced = 0;
+    int sent = 0;
+    int received = 0;
+    int late = 0;
+};
+
+} // anonymous namespace
+
+/**
+ * Drive a ring of queues with declared lookaheads, from a queue to the
+ * next, shorter than the quantum, so that the queues synchronize on the
+ * lookaheads rather than on the quantum, and check that every queue
+ * still services its events in order.
+ */
+TEST(SimulateTest, LookaheadSync)
+{
+    const int num_queues = 4;
+    lookaheadSync = true;
+    simQuantum = 100000;
+
+    for (int i = 0; i < num_queues; i++)
+        getEventQueue(i);
+    curEventQueue(mainEventQueue[0]);
+
+    std::vector<std::unique_ptr<Node>> nodes;
+    for (int i = 0; i < num_queues; i++) {
+        const Tick latency = 2000 + 500 * i;
+        nodes.emplace_back(new Node(i, mainEventQueue[i], latency));
+        declareLookahead(i, (i + 1) % num_queues, latency);
+    }
+    for (int i = 0; i < num_queues; i++)
+        nodes[i]->next = nodes[(i + 1) % num_queues].get();
+
+    for (int run = 0; run < 3; run++) {
+        GlobalSimLoopExitEvent *exit_event = simulate(1000000);
+        ASSERT_EQ(exit_event->getCause(), "simulate() limit reached");
+    }
+    terminateEventQueueThreads();
+    lookaheadSync = false;
+
+    for (int i = 0; i < num_queues; i++) {
+        const Node &node = *nodes[i];
+        const Node &prev = *nodes[(i + num_queues - 1) % num_queues];
+        EXPECT_EQ(node.late, 0) << "Queue " << i;
+        EXPECT_GT(node.received, 0) << "Queue " << i;
+        // Only the messages sent in the last latency may be in flight
+        EXPECT_LE(node.received, prev.sent) << "Queue " << i;
+        EXPECT_GE(node.received, prev.sent - 1 - int(prev.latency /
+                                                     prev.period))
+            << "Queue " << i;
+    }
+}
@@ -0,0 +1,87 @@
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+# Warm a two-set, two-way LRU cache up from cache-warmup.trc, and check
+# the blocks it ends up holding. The trace fills three blocks in set 0,
+# so the least recently used one is evicted, writes one block in set 1,
+# and makes an uncacheable access that must be skipped. The warm-up
+# accesses must not show in the stats of the tags or of the partitions.
+
+import os
+import sys
+
+import m5
+from m5.objects import *
+
+system = System(physmem = SimpleMemory(),
+                membus = SystemXBar())
+system.voltage_domain = VoltageDomain()
+system.clk_domain = SrcClockDomain(clock = '1GHz',
+                                   voltage_domain = system.voltage_domain)
+
+# Never started, it only names the requestor of the trace
+system.tgen = PyTrafficGen()
+
+system.partitioning = WayPartitioningPolicy(partitions = ['system.tgen'],
+                                            way_masks = [0x3])
+system.cache = Cache(size = '256B', assoc = 2, tag_latency = 1,
+                     data_latency = 1, response_latency = 1, mshrs = 4,
+                     tgts_per_mshr = 4, replacement_policy = LRURP(),
+                     tags = BaseSetAssoc(
+                         partitioning_policy = system.partitioning),
+                     warmup_trace = os.path.join(
+                         os.path.dirname(os.path.abspath(__file__)),
+                         'cache-warmup.trc'))
+system.tgen.port = system.cache.cpu_side
+system.cache.mem_side = system.membus.cpu_side_ports
+
+system.system_port = system.membus.cpu_side_ports
+system.physmem.port = system.membus.mem_side_ports
+
+root = Root( full_system = False, system = system )
+root.system.mem_mode = 'timing'
+
+m5.instantiate()
+# The cache warms up when the simulation starts
+exit_event = m5.simulate(1000)
+if exit_event.getCause() != "simulate() limit reached":
+    sys.exit(1)
+
+cache = system.cache.getCCObject()
+for addr, cached in ((0x000, True), (0x080, False), (0x100, True),
+                     (0x040, True), (0x0c0, False)):
+    if cache.inCache(addr, False) != cached:
+        sys.exit("Block %#x is %s the warmed cache" %
+                 (addr, "missing from" if cached else "in"))
+
+policy = system.partitioning.getCCObject()
+if policy.getOccupancy(0) != 3:
+    sys.exit("Partition holds %d blocks instead of 3" %
+             policy.getOccupancy(0))
+
+for group, stat in ((system.cache.tags, 'tagAccesses'),
+                    (system.partitioning, 'hits'),
+                    (system.partitioning, 'misses')):
+    value = group.getCCObject().resolveStat(stat).total
+    if value:
+        sys.exit("%s.%s counts %d warm-up accesses" % (group, stat, value))
@@ -0,0 +1,108 @@
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+# Two identical hierarchies run the same workload behind a Hawkeye L2;
+# one of them trains on every set, the other only on a quarter of the
+# sets. Each workload mixes reads of a hot region that fits in the
+# cache with a streaming scan, issued by two generators whose dummy PCs
+# differ, so the predictor has something to learn. Sampling is expected
+# to cost little, so the demand hit rates of the two caches must stay
+# close.
+
+import sys
+
+import m5
+from m5.objects import *
+m5.util.addToPath('../../../configs/')
+from common.Caches import *
+
+# 64 sets of 16 ways
+l2_size = 64 * 1024
+hot_size = 48 * 1024
+scan_size = 16 * 1024 * 1024
+region_size = 256 * 1024 * 1024
+duration = 2000000000
+tolerance = 0.05
+
+system = System(physmem = SimpleMemory(range = AddrRange(2 * region_size),
+                                       bandwidth = '64GiB/s'),
+                membus = SystemXBar())
+system.voltage_domain = VoltageDomain()
+system.clk_domain = SrcClockDomain(clock = '1GHz',
+                                   voltage_domain = system.voltage_domain)
+system.mem_ranges = [system.physmem.range]
+
+def hierarchy(sampled_sets):
+    l2c = L2Cache(size = l2_size, assoc = 16,
+                  replacement_policy = HawkeyeRP(sampled_sets = sampled_sets))
+    l2c.xbar = L2XBar()
+    l2c.cpu_side = l2c.xbar.mem_side_ports
+    l2c.mem_side = system.membus.cpu_side_ports
+    l2c.hot = PyTrafficGen()
+    l2c.scan = PyTrafficGen()
+    l2c.hot.port = l2c.xbar.cpu_side_ports
+    l2c.scan.port = l2c.xbar.cpu_side_ports
+    return l2c
+
+system.full = hierarchy(0)
+system.sampled = hierarchy(16)
+hierarchies = [system.full, system.sampled]
+
+system.system_port = system.membus.cpu_side_ports
+system.physmem.port = system.membus.mem_side_ports
+
+root = Root( full_system = False, system = system )
+root.system.mem_mode = 'timing'
+
+m5.instantiate()
+
+for i, l2c in enumerate(hierarchies):
+    base = i * region_size
+    l2c.hot.start(iter([
+        l2c.hot.createRandom(duration, base, base + hot_size - 1, 64,
+                             2000, 2000, 100, 0),
+        l2c.hot.createExit(0)]))
+    l2c.scan.start(iter([
+        l2c.scan.createLinear(duration, base + hot_size,
+                              base + hot_size + scan_size - 1, 64,
+                              10000, 10000, 100, 0),
+        l2c.scan.createExit(0)]))
+
+exit_event = m5.simulate()
+if "exit state" not in exit_event.getCause():
+    sys.exit("Unexpected exit: %s" % exit_event.getCause())
+
+hit_rates = []
+for l2c in hierarchies:
+    stats = l2c.getCCObject()
+    hits = stats.resolveStat('demandHits').total
+    accesses = stats.resolveStat('demandAccesses').total
+    if not accesses:
+        sys.exit("%s saw no demand accesses" % l2c)
+    hit_rates.append(hits / accesses)
+
+print("Hit rate training on all sets: %.4f, on sampled sets: %.4f" %
+      tuple(hit_rates))
+if abs(hit_rates[0] - hit_rates[1]) > tolerance:
+    sys.exit("Set sampling changes the hit rate by more than %.2f" %
+             tolerance)
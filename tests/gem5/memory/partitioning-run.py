@@ -0,0 +1,107 @@
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+# Testers in two partitions, and one outside of them, sharing a TreePLRU
+# L2 whose ways are split between the partitions. The replacement policy
+# is only ever given the ways of a partition to choose from, so the
+# blocks a partition fills must fit in its ways. The masks are swapped
+# halfway, and the blocks are accounted to their partition throughout.
+
+import sys
+
+import m5
+from m5.objects import *
+m5.util.addToPath('../../../configs/')
+from common.Caches import *
+
+nb_cores = 4
+
+system = System(physmem = SimpleMemory(),
+                membus = SystemXBar())
+system.voltage_domain = VoltageDomain()
+system.clk_domain = SrcClockDomain(clock = '1GHz',
+                                   voltage_domain = system.voltage_domain)
+
+system.cpu_clk_domain = SrcClockDomain(clock = '2GHz',
+                                       voltage_domain = system.voltage_domain)
+
+system.toL2Bus = L2XBar(clk_domain = system.cpu_clk_domain)
+# 32 sets of 8 ways, of which cpu0 and cpu1 get 2 and cpu2 the others,
+# while cpu3 and the writebacks may allocate anywhere
+system.partitioning = WayPartitioningPolicy(
+    partitions = ['system.cpu0 system.cpu1', 'system.cpu2'],
+    way_masks = [0x03, 0xfc])
+system.l2c = L2Cache(clk_domain = system.cpu_clk_domain, size = '16kB',
+                     assoc = 8, replacement_policy = TreePLRURP(),
+                     tags = BaseSetAssoc(
+                         partitioning_policy = system.partitioning))
+system.l2c.cpu_side = system.toL2Bus.mem_side_ports
+system.l2c.mem_side = system.membus.cpu_side_ports
+
+system.cpu = [ MemTest(max_loads = 1e5, progress_interval = 1e4)
+               for i in range(nb_cores) ]
+for cpu in system.cpu:
+    cpu.clk_domain = system.cpu_clk_domain
+    cpu.l1c = L1Cache(size = '4kB', assoc = 4)
+    cpu.l1c.cpu_side = cpu.port
+    cpu.l1c.mem_side = system.toL2Bus.cpu_side_ports
+
+system.system_port = system.membus.cpu_side_ports
+
+system.physmem.port = system.membus.mem_side_ports
+
+root = Root( full_system = False, system = system )
+root.system.mem_mode = 'timing'
+
+num_sets = 32
+
+def check_occupancy(way_masks):
+    for partition, mask in enumerate(way_masks):
+        if policy.getWayMask(partition) != mask:
+            sys.exit("Partition %d has way mask %#x instead of %#x" %
+                     (partition, policy.getWayMask(partition), mask))
+        occupancy = policy.getOccupancy(partition)
+        capacity = bin(mask).count('1') * num_sets
+        if not 0 < occupancy <= capacity:
+            sys.exit("Partition %d holds %d blocks in %d entries" %
+                     (partition, occupancy, capacity))
+
+m5.instantiate()
+exit_event = m5.simulate(20000000)
+if exit_event.getCause() != "simulate() limit reached":
+    sys.exit(1)
+policy = system.partitioning.getCCObject()
+check_occupancy([0x03, 0xfc])
+
+# The blocks filled so far stay in the ways they were filled in until
+# they are evicted, so after the swap only check the accounting
+policy.setWayMask(0, 0xfc)
+policy.setWayMask(1, 0x03)
+exit_event = m5.simulate()
+if exit_event.getCause() != "maximum number of loads reached":
+    sys.exit(1)
+occupancies = [ policy.getOccupancy(partition) for partition in range(2) ]
+if policy.getWayMask(0) != 0xfc or policy.getWayMask(1) != 0x03 or \
+   sum(occupancies) > num_sets * 8:
+    sys.exit("Partitions hold %s blocks after swapping their ways" %
+             occupancies)
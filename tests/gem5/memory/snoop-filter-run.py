@@ -0,0 +1,117 @@
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+# Two clusters of testers sharing the same lines, each behind a crossbar
+# with a small set associative snoop filter. The filters are full for most
+# of the run, so the snoops that the other cluster sends up through the L2
+# regularly miss in them, and their evictions back-invalidate the L1s.
+#
+# With --pending-writebacks, the testers mostly write to small L1s that
+# evict dirty lines all the time, while a slow L2 keeps the writebacks
+# waiting in the write buffers of the L1s. The filters then regularly
+# back-invalidate lines that are still being written back, which must
+# neither lose the data nor stop tracking the L1 until the writeback is
+# through.
+
+import argparse
+import sys
+
+import m5
+from m5.objects import *
+m5.util.addToPath('../../../configs/')
+from common.Caches import *
+
+parser = argparse.ArgumentParser()
+parser.add_argument('--pending-writebacks', action='store_true',
+                    help="Back-invalidate lines with writebacks in flight")
+args = parser.parse_args()
+
+nb_clusters = 2
+nb_cores = 4
+
+if args.pending_writebacks:
+    physmem = SimpleMemory(latency = '200ns', bandwidth = '1GiB/s')
+else:
+    physmem = SimpleMemory()
+system = System(physmem = physmem, membus = SystemXBar())
+system.voltage_domain = VoltageDomain()
+system.clk_domain = SrcClockDomain(clock = '1GHz',
+                                   voltage_domain = system.voltage_domain)
+
+system.cpu_clk_domain = SrcClockDomain(clock = '2GHz',
+                                       voltage_domain = system.voltage_domain)
+
+cpus = []
+clusters = []
+for i in range(nb_clusters):
+    cluster = SubSystem()
+    # 128 lines, in 8 sets of 16, so that the 16 L1 MSHRs of a cluster
+    # cannot fill a set with requests in flight
+    cluster.toL2Bus = L2XBar(clk_domain = system.cpu_clk_domain,
+                             snoop_filter = SnoopFilter(
+                                 lookup_latency = 0, max_capacity = '8KiB',
+                                 assoc = 16))
+    cluster.l2c = L2Cache(clk_domain = system.cpu_clk_domain, size = '64kB',
+                          assoc = 8)
+    if args.pending_writebacks:
+        cluster.l2c.mshrs = 2
+        cluster.l2c.write_buffers = 2
+    cluster.l2c.cpu_side = cluster.toL2Bus.mem_side_ports
+    cluster.l2c.mem_side = system.membus.cpu_side_ports
+
+    cluster.cpu = [ MemTest(max_loads = 1e5, progress_interval = 1e4)
+                    for j in range(nb_cores) ]
+    for cpu in cluster.cpu:
+        cpu.clk_domain = system.cpu_clk_domain
+        if args.pending_writebacks:
+            cpu.max_loads = 2e4
+            cpu.percent_reads = 30
+            cpu.percent_functional = 0
+            cpu.percent_uncacheable = 0
+            cpu.l1c = L1Cache(size = '1kB', assoc = 2, write_buffers = 16)
+        else:
+            cpu.l1c = L1Cache(size = '32kB', assoc = 4)
+        cpu.l1c.cpu_side = cpu.port
+        cpu.l1c.mem_side = cluster.toL2Bus.cpu_side_ports
+    cpus += cluster.cpu
+    clusters.append(cluster)
+
+system.cluster = clusters
+
+system.system_port = system.membus.cpu_side_ports
+
+system.physmem.port = system.membus.mem_side_ports
+
+root = Root( full_system = False, system = system )
+root.system.mem_mode = 'timing'
+
+m5.instantiate()
+exit_event = m5.simulate()
+if exit_event.getCause() != "maximum number of loads reached":
+    exit(1)
+
+if args.pending_writebacks:
+    in_flight = sum(cluster.toL2Bus.snoop_filter.getCCObject().resolveStat(
+        'evictionsInFlight').value for cluster in clusters)
+    if not in_flight:
+        sys.exit("No line was back-invalidated with a writeback in flight")
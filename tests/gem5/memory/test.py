@@ -67,6 +67,46 @@ gem5_verify_config(
     valid_isas=(constants.null_tag,),
 )
 
+gem5_verify_config(
+    name='memtest_snoop_filter_assoc',
+    verifiers=(), # No need for verfiers this will return non-zero on fail
+    config=joinpath(getcwd(), 'snoop-filter-run.py'),
+    config_args = [],
+    valid_isas=(constants.null_tag,),
+)
+
+gem5_verify_config(
+    name='memtest_snoop_filter_assoc_pending_writebacks',
+    verifiers=(), # No need for verfiers this will return non-zero on fail
+    config=joinpath(getcwd(), 'snoop-filter-run.py'),
+    config_args = ['--pending-writebacks'],
+    valid_isas=(constants.null_tag,),
+)
+
+gem5_verify_config(
+    name='memtest_way_partitioning',
+    verifiers=(), # No need for verfiers this will return non-zero on fail
+    config=joinpath(getcwd(), 'partitioning-run.py'),
+    config_args = [],
+    valid_isas=(constants.null_tag,),
+)
+
+gem5_verify_config(
+    name='hawkeye_set_sampling',
+    verifiers=(), # No need for verfiers this will return non-zero on fail
+    config=joinpath(getcwd(), 'hawkeye-sampling-run.py'),
+    config_args = [],
+    valid_isas=(constants.null_tag,),
+)
+
+gem5_verify_config(
+    name='cache_warmup_trace',
+    verifiers=(), # No need for verfiers this will return non-zero on fail
+    config=joinpath(getcwd(), 'cache-warmup-run.py'),
+    config_args = [],
+    valid_isas=(constants.null_tag,),
+)
+
 null_tests = [
     ('garnet_synth_traffic', None, ['--sim-cycles', '5000000']),
     ('memcheck', None, ['--maxtick', '2000000000', '--prefetchers']),
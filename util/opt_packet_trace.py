@@ -0,0 +1,388 @@
+#!/usr/bin/env python3
+
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+# This script replays a protobuf packet trace, e.g., one recorded by a
+# MemTraceProbe in front of the last level cache, through Belady's MIN
+# and through the OPTgen approximation used by the Hawkeye replacement
+# policy, and reports the hit rates they reach on a set associative cache.
+#
+# Only the demand reads and writes count as accesses; writebacks, clean
+# evictions, prefetches and the other commands are skipped.
+#
+# The trace is read in large blocks that are cut at message boundaries
+# and decoded by a pool of worker processes, which bin the line address
+# of every access by set. The bins are appended, in trace order, to
+# temporary partition files. Each partition is then streamed through the
+# two policies by a worker, so memory use is bounded by the number of
+# distinct lines of a partition rather than by the size of the trace.
+#
+# The protobuf bindings are (re)built with make in this directory when
+# the script starts.
+
+import argparse
+import array
+import collections
+import heapq
+import multiprocessing
+import os
+import protolib
+import subprocess
+import tempfile
+
+# Demand read and write requests, by their index in the Command enum of
+# src/mem/packet.hh
+DEMAND_CMDS = {
+    1,  # ReadReq
+    4,  # WriteReq
+    16, # WriteLineReq
+    22, # ReadExReq
+    24, # ReadCleanReq
+    25, # ReadSharedReq
+    26, # LoadLockedReq
+    27, # StoreCondReq
+    30, # LockedRMWReadReq
+    32, # LockedRMWWriteReq
+    34, # SwapReq
+}
+
+# Size of the blocks of the trace handed to the decoding workers
+CHUNK_BYTES = 4 << 20
+
+# Number of line addresses read or written at once from a partition
+IO_LINES = 1 << 16
+
+# Next use of a line that is never accessed again
+NEVER = (1 << 64) - 1
+
+def _decode_varint(buf, pos):
+    """Decode the varint at pos in buf. Returns its value and the offset
+    following it, and raises IndexError if buf ends within it."""
+
+    result = 0
+    shift = 0
+    while True:
+        b = buf[pos]
+        pos += 1
+        result |= (b & 0x7f) << shift
+        if not b & 0x80:
+            return result, pos
+        shift += 7
+
+def _complete_messages(buf):
+    """Length of the longest prefix of buf that holds whole
+    length-delimited messages."""
+
+    end = 0
+    while end < len(buf):
+        try:
+            size, start = _decode_varint(buf, end)
+        except IndexError:
+            break
+        if start + size > len(buf):
+            break
+        end = start + size
+    return end
+
+def decode_chunk(job):
+    """Decode a block of length-delimited packets. Returns the line
+    addresses of its demand accesses binned by partition, as raw
+    bytes, and the number of packets that were skipped."""
+
+    import packet_pb2
+
+    buf, num_sets, line_size, partitions = job
+
+    bins = [array.array('Q') for _ in range(partitions)]
+    num_skipped = 0
+    packet = packet_pb2.Packet()
+    pos = 0
+    while pos < len(buf):
+        size, pos = _decode_varint(buf, pos)
+        packet.ParseFromString(buf[pos:pos + size])
+        pos += size
+        if packet.cmd not in DEMAND_CMDS:
+            num_skipped += 1
+            continue
+        line = packet.addr // line_size
+        bins[(line % num_sets) % partitions].append(line)
+
+    return [b.tobytes() for b in bins], num_skipped
+
+def split_trace(pool, jobs, trace, num_sets, line_size, partitions,
+                tmp_dir):
+    """Decode the trace in parallel and write the line address of every
+    access to the partition of its set, preserving the trace order.
+    Returns the partition file names, the number of accesses and the
+    number of skipped packets."""
+
+    import packet_pb2
+
+    proto_in = protolib.openFileRd(trace)
+
+    # Read the magic number in 4-byte Little Endian
+    magic_number = proto_in.read(4).decode()
+    if magic_number != "gem5":
+        print("Unrecognized file", trace)
+        exit(-1)
+
+    header = packet_pb2.PacketHeader()
+    protolib.decodeMessage(proto_in, header)
+
+    names = [os.path.join(tmp_dir, 'part%d' % i) for i in range(partitions)]
+    files = [open(name, 'wb') for name in names]
+
+    num_accesses = 0
+    num_skipped = 0
+
+    def write_back(result):
+        nonlocal num_accesses, num_skipped
+        bins, skipped = result.get()
+        for data, f in zip(bins, files):
+            f.write(data)
+            num_accesses += len(data) // 8
+        num_skipped += skipped
+
+    # Chunks are decoded out of order, but written back in order; at
+    # most two per worker are in flight to bound the memory use
+    pending = collections.deque()
+    tail = b''
+    while True:
+        block = proto_in.read(CHUNK_BYTES)
+        if not block:
+            break
+        buf = tail + block
+        end = _complete_messages(buf)
+        tail = buf[end:]
+        if end == 0:
+            continue
+        if len(pending) >= 2 * jobs:
+            write_back(pending.popleft())
+        pending.append(pool.apply_async(
+            decode_chunk, ((buf[:end], num_sets, line_size, partitions),)))
+
+    while pending:
+        write_back(pending.popleft())
+    if tail:
+        print("Ignoring %d bytes of truncated packet at the end of the "
+              "trace" % len(tail))
+
+    for f in files:
+        f.close()
+    proto_in.close()
+
+    return names, num_accesses, num_skipped
+
+def read_lines(f, reverse=False):
+    """Iterate over the line addresses of a partition file, from the
+    last one when reverse is set."""
+
+    if not reverse:
+        while True:
+            block = array.array('Q')
+            block.frombytes(f.read(IO_LINES * 8))
+            if not block:
+                return
+            yield from block
+
+    end = f.seek(0, os.SEEK_END)
+    while end > 0:
+        start = max(0, end - IO_LINES * 8)
+        f.seek(start)
+        block = array.array('Q')
+        block.frombytes(f.read(end - start))
+        block.reverse()
+        yield from block
+        end = start
+
+def write_next_uses(name, next_name):
+    """Write the position in the partition of the next access to the same
+    line as every access, or NEVER. The positions are computed by
+    streaming the partition backwards, and are written in that
+    order."""
+
+    last_seen = {}
+    block = array.array('Q')
+    with open(name, 'rb') as f, open(next_name, 'wb') as out:
+        pos = os.path.getsize(name) // 8
+        for line in read_lines(f, reverse=True):
+            pos -= 1
+            block.append(last_seen.get(line, NEVER))
+            last_seen[line] = pos
+            if len(block) >= IO_LINES:
+                block.tofile(out)
+                del block[:]
+        block.tofile(out)
+
+class SetState:
+    """Belady's MIN and OPTgen state of one set."""
+
+    def __init__(self, vec_size):
+        self.accesses = 0
+        self.min_hits = 0
+        self.optgen_hits = 0
+        # Next use of the resident lines
+        self.resident = {}
+        # Max-heap of (-next use, line); entries go stale when a line
+        # is accessed again and are skipped lazily
+        self.heap = []
+        self.occupancy = [0] * vec_size
+
+    def belady_access(self, line, next_use, ways):
+        if line in self.resident:
+            self.min_hits += 1
+        elif len(self.resident) >= ways:
+            while True:
+                neg_use, victim = heapq.heappop(self.heap)
+                if self.resident.get(victim) == -neg_use:
+                    del self.resident[victim]
+                    break
+        self.resident[line] = next_use
+        heapq.heappush(self.heap, (-next_use, line))
+
+    def optgen_access(self, curr, prev, ways):
+        """Mirror of the linear backend of OPTgen::add_cache_access and
+        OPTgen::get_decision in
+        src/mem/cache/replacement_policies/optgen.cc. Timestamps wrap
+        around the occupancy vector: a reuse exactly one vector length
+        away finds prev == curr and is a hit, and older reuses alias
+        to a younger one, just as in the C++ code."""
+
+        vec_size = len(self.occupancy)
+        self.occupancy[curr] = 1
+        if prev is None:
+            return
+        if prev == curr:
+            self.optgen_hits += 1
+            return
+
+        span = range(prev, curr) if prev < curr else \
+            list(range(prev, vec_size)) + list(range(curr))
+        occupancy = self.occupancy
+        if all(occupancy[t] < ways for t in span):
+            self.optgen_hits += 1
+            for t in span:
+                occupancy[t] += 1
+
+def simulate_partition(job):
+    """Stream a partition through Belady's MIN and OPTgen. Returns a list
+    of (set, accesses, MIN hits, OPTgen hits)."""
+
+    name, num_sets, ways, vec_size = job
+
+    next_name = name + '.next'
+    write_next_uses(name, next_name)
+
+    sets = {}
+    # Timestamp of the last access to every line, within its set
+    last_seen = {}
+    with open(name, 'rb') as f, open(next_name, 'rb') as next_f:
+        next_uses = read_lines(next_f, reverse=True)
+        for line, next_use in zip(read_lines(f), next_uses):
+            s = line % num_sets
+            state = sets.get(s)
+            if state is None:
+                state = sets[s] = SetState(vec_size)
+
+            curr = state.accesses % vec_size
+            state.accesses += 1
+            state.optgen_access(curr, last_seen.get(line), ways)
+            last_seen[line] = curr
+            state.belady_access(line, next_use, ways)
+
+    os.remove(name)
+    os.remove(next_name)
+
+    return [(s, state.accesses, state.min_hits, state.optgen_hits)
+            for s, state in sets.items()]
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Report the hit rates of Belady's MIN and of OPTgen "
+                    "on a packet trace.")
+    parser.add_argument('trace', help="Protobuf packet trace, optionally "
+                        "gzipped")
+    parser.add_argument('--sets', type=int, required=True,
+                        help="Number of sets of the cache")
+    parser.add_argument('--ways', type=int, required=True,
+                        help="Associativity of the cache")
+    parser.add_argument('--line-size', type=int, default=64,
+                        help="Cache line size in bytes")
+    parser.add_argument('--occupancy-vec-size', type=int, default=128,
+                        help="Length of OPTgen's history, in accesses to "
+                        "a set")
+    parser.add_argument('--jobs', type=int, default=os.cpu_count(),
+                        help="Number of worker processes decoding the "
+                        "trace and simulating the partitions")
+    parser.add_argument('--partitions', type=int, default=None,
+                        help="Number of partitions the trace is split in; "
+                        "more partitions lower the memory use, but each "
+                        "one holds a file open. Defaults to 16 per job, "
+                        "up to 512")
+    parser.add_argument('--per-set', metavar='CSV',
+                        help="Write the per-set results to this file")
+    parser.add_argument('--tmp-dir', default=None,
+                        help="Directory for the partitioned trace")
+    args = parser.parse_args()
+
+    # Make sure the proto definitions are up to date
+    util_dir = os.path.dirname(os.path.realpath(__file__))
+    subprocess.check_call(['make', '--quiet', '-C', util_dir,
+                           'packet_pb2.py'])
+
+    partitions = args.partitions or min(16 * args.jobs, 512)
+    partitions = max(1, min(partitions, args.sets))
+
+    with tempfile.TemporaryDirectory(dir=args.tmp_dir) as tmp_dir, \
+         multiprocessing.Pool(args.jobs) as pool:
+        print("Splitting trace in %d partitions" % partitions)
+        names, num_accesses, num_skipped = split_trace(
+            pool, args.jobs, args.trace, args.sets, args.line_size,
+            partitions, tmp_dir)
+        print("Parsed packets: %d, skipped %d that are not demand "
+              "accesses" % (num_accesses + num_skipped, num_skipped))
+
+        jobs = [(name, args.sets, args.ways, args.occupancy_vec_size)
+                for name in names]
+        results = []
+        for part in pool.imap_unordered(simulate_partition, jobs):
+            results.extend(part)
+
+    results.sort()
+    if args.per_set:
+        with open(args.per_set, 'w') as csv:
+            csv.write("set,accesses,min_hits,optgen_hits\n")
+            for s, accesses, min_hits, opt_hits in results:
+                csv.write("%d,%d,%d,%d\n" % (s, accesses, min_hits,
+                                             opt_hits))
+
+    total_min = sum(r[2] for r in results)
+    total_optgen = sum(r[3] for r in results)
+    print("Accesses: %d" % num_accesses)
+    for name, hits in (("Belady MIN", total_min), ("OPTgen", total_optgen)):
+        hit_rate = hits / num_accesses if num_accesses else 0.0
+        print("%s hits: %d (hit rate %.4f)" % (name, hits, hit_rate))
+
+if __name__ == "__main__":
+    main()